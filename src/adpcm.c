@@ -0,0 +1,78 @@
+#include "gbalib.h"
+#include "adpcm.h"
+
+// Standard IMA ADPCM tables. tools/wav2adpcm.py must use the same ones.
+static const unsigned short stepTable[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41,
+    45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209,
+    230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876,
+    963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749,
+    3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+    9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623,
+    27086, 29794, 32767
+};
+
+static const signed char indexTable[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+// Loads the decoder state from a block's header, ready to decode the block
+// from its first sample
+void startAdpcmBlock(ADPCM_DECODER *decoder, const unsigned char *block) {
+    decoder->predicted = (short) (block[0] | (block[1] << 8));
+    decoder->index = block[2];
+    decoder->data = block + ADPCM_HEADER_SIZE;
+    decoder->position = 0;
+}
+
+// Decodes the next samples of the current block into signed 8-bit samples,
+// ready to be fed to a Direct Sound FIFO. Decoding can stop and pick up again
+// anywhere in the block, but not past its end.
+IWRAM_CODE void decodeAdpcm(ADPCM_DECODER *decoder, signed char *out, int samples) {
+    int predicted = decoder->predicted;
+    int index = decoder->index;
+    const unsigned char *data = decoder->data;
+    int end = decoder->position + samples;
+    
+    for (int i = decoder->position; i < end; i++) {
+        int nibble = (i & 1) ? data[i >> 1] >> 4 : data[i >> 1] & 0xF;
+        int step = stepTable[index];
+        
+        int diff = step >> 3;
+        if (nibble & 1) {
+            diff += step >> 2;
+        }
+        if (nibble & 2) {
+            diff += step >> 1;
+        }
+        if (nibble & 4) {
+            diff += step;
+        }
+        
+        if (nibble & 8) {
+            predicted -= diff;
+            if (predicted < -32768) {
+                predicted = -32768;
+            }
+        } else {
+            predicted += diff;
+            if (predicted > 32767) {
+                predicted = 32767;
+            }
+        }
+        
+        index += indexTable[nibble];
+        if (index < 0) {
+            index = 0;
+        } else if (index > 88) {
+            index = 88;
+        }
+        
+        *out++ = predicted >> 8;
+    }
+    
+    decoder->predicted = predicted;
+    decoder->index = index;
+    decoder->position = end;
+}
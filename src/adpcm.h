@@ -0,0 +1,18 @@
+// Compressed audio is stored as 4-bit IMA ADPCM in fixed size blocks. Each
+// block starts with a 4 byte header holding the decoder state (the 16-bit
+// predicted sample, little endian, then the step index and a padding byte),
+// followed by two samples per byte, low nibble first. Every block can be
+// decoded on its own, which is what makes seeking and looping possible.
+#define ADPCM_HEADER_SIZE 4
+#define ADPCM_BLOCK_SIZE(samples) (ADPCM_HEADER_SIZE + (samples) / 2)
+
+// Decoder state, so a block can be decoded a few samples at a time
+typedef struct {
+    const unsigned char *data;
+    int position; // samples decoded since the block header
+    int predicted;
+    int index;
+} ADPCM_DECODER;
+
+void startAdpcmBlock(ADPCM_DECODER *decoder, const unsigned char *block);
+void decodeAdpcm(ADPCM_DECODER *decoder, signed char *out, int samples);
@@ -0,0 +1,145 @@
+#include "gbalib.h"
+#include "clock.h"
+#include "debug.h"
+#include "gameboard.h"
+#include "pentomino.h"
+#include "benchmark.h"
+#include "background/BACKGROUND.h"
+#include "sprite/TILE_F.h"
+
+// How much of each workload to run. Each takes somewhere around a frame or
+// more, so the few cycles spent reading the clock don't matter.
+#define BLIT_TILES 240
+#define ROM_READ_SIZE 16384
+#define TILE_SUM_PASSES 64
+#define TILE_SUM_SIZE (BOARD_WIDTH * BOARD_HEIGHT)
+
+// The same tiles in IWRAM, where game state lives, and in EWRAM
+static TILE iwramTiles[TILE_SUM_SIZE];
+static TILE ewramTiles[TILE_SUM_SIZE] EWRAM_BSS;
+
+// Results go here so the work can't be optimized away
+static volatile unsigned int sink;
+
+static unsigned int _benchCollision();
+static unsigned int _benchBlit(const unsigned short *tile);
+static unsigned int _benchRomRead();
+static unsigned int _benchTileSum(const TILE *tiles);
+static unsigned int _sumTiles(const TILE *tiles, int count);
+static void _report(const char *name, unsigned int cycles);
+
+// Runs every benchmark once and logs how many cycles each took. Interrupts are
+// off while they run, so only DMA from the sound hardware gets in the way.
+void runBenchmarks() {
+    if (!hasDebugLog()) {
+        return;
+    }
+    
+    unsigned short ime = REG_IME;
+    REG_IME = 0;
+    
+    // Collision checks are IWRAM_CODE, so these run from ROM only in a
+    // ROM_ONLY build
+    REG_WAITCNT = 0;
+    _report("collision waitcnt=0000", _benchCollision());
+    REG_WAITCNT = WAITCNT_FAST;
+    _report("collision waitcnt=4317", _benchCollision());
+    
+    // Thumb code in ROM reading data from ROM, with and without the faster
+    // wait states and prefetch
+    REG_WAITCNT = 0;
+    _report("rom-read waitcnt=0000", _benchRomRead());
+    REG_WAITCNT = WAITCNT_FAST;
+    _report("rom-read waitcnt=4317", _benchRomRead());
+    
+    // Tile sprites are copied to IWRAM at boot to be blitted from there
+    _report("blit sprite=rom", _benchBlit(TILE_F_data));
+    _report("blit sprite=iwram", _benchBlit(tileSpriteForType(F)));
+    
+    // Game state is left in IWRAM rather than moved out to EWRAM
+    _report("tiles data=iwram", _benchTileSum(iwramTiles));
+    _report("tiles data=ewram", _benchTileSum(ewramTiles));
+    
+    REG_IME = ime;
+}
+
+// Checks every pentomino in every rotation at every position on the empty
+// board, and drops it wherever it fits
+static unsigned int _benchCollision() {
+    unsigned int start = getCycles();
+    unsigned int total = 0;
+    
+    for (int t = F; t <= PENTOMINO_TYPES; t++) {
+        PENTOMINO pent = getPentomino(t);
+        for (int r = 0; r < 4; r++) {
+            for (int y = 0; y < BOARD_HEIGHT; y++) {
+                for (int x = 0; x < BOARD_WIDTH; x++) {
+                    pent.pos.x = x;
+                    pent.pos.y = y;
+                    if (isPentominoValid(pent)) {
+                        total += dropDistance(pent);
+                    }
+                }
+            }
+            pent = rotateCW(pent);
+        }
+    }
+    
+    sink = total;
+    return getCycles() - start;
+}
+
+// Fills the screen with a tile, the way the board is drawn
+static unsigned int _benchBlit(const unsigned short *tile) {
+    unsigned int start = getCycles();
+    
+    for (int i = 0; i < BLIT_TILES; i++) {
+        drawTileAtPixel((i % 30) * TILE_SIZE_PX, (i / 30) * TILE_SIZE_PX, tile);
+    }
+    
+    return getCycles() - start;
+}
+
+static unsigned int _benchRomRead() {
+    unsigned int start = getCycles();
+    unsigned int total = 0;
+    
+    for (int i = 0; i < ROM_READ_SIZE; i++) {
+        total += BACKGROUND_data[i];
+    }
+    
+    sink = total;
+    return getCycles() - start;
+}
+
+static unsigned int _benchTileSum(const TILE *tiles) {
+    unsigned int start = getCycles();
+    unsigned int total = 0;
+    
+    for (int i = 0; i < TILE_SUM_PASSES; i++) {
+        total += _sumTiles(tiles, TILE_SUM_SIZE);
+    }
+    
+    sink = total;
+    return getCycles() - start;
+}
+
+// Runs from IWRAM, so only where the data is makes a difference
+IWRAM_CODE __attribute__((noinline))
+static unsigned int _sumTiles(const TILE *tiles, int count) {
+    unsigned int total = 0;
+    for (int i = 0; i < count; i++) {
+        total += tiles[i];
+    }
+    return total;
+}
+
+static void _report(const char *name, unsigned int cycles) {
+    volatile char *out = DEBUG_LOG_BUFFER;
+    out += writeDebugString(out, "bench ");
+    out += writeDebugString(out, name);
+    *out++ = ' ';
+    out += writeDebugDecimal(out, cycles);
+    *out = '\0';
+    sendDebugLog();
+}
@@ -0,0 +1,13 @@
+// Placement benchmark (make BENCHMARK=1). At boot, the work that decided what
+// goes in IWRAM and how ROM is set up is timed, and the cycle counts are
+// written to the debug log. Build again with ROM_ONLY=1 to see what the
+// IWRAM_CODE functions cost from ROM. In normal builds BENCHMARK_RUN compiles
+// to nothing.
+
+#ifdef BENCHMARK
+#define BENCHMARK_RUN() runBenchmarks()
+#else
+#define BENCHMARK_RUN()
+#endif
+
+void runBenchmarks();
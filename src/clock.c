@@ -0,0 +1,33 @@
+#include "gbalib.h"
+#include "clock.h"
+
+// Starts the free-running cycle counter. Timer 2 ticks once per CPU cycle and
+// overflows into timer 3, so together they count 2^32 cycles (about 256
+// seconds) before wrapping around. Callers should only ever look at the
+// difference between two readings, which stays correct across a wrap. Each
+// overflow of the low timer raises CLOCK_OVERFLOW_IRQ, but nothing hears it
+// until a handler is registered and the interrupt is enabled.
+void initClock() {
+    REG_TMCNT(CLOCK_TIMER_LO) = 0;
+    REG_TMCNT(CLOCK_TIMER_HI) = 0;
+    REG_TMD(CLOCK_TIMER_LO) = 0;
+    REG_TMD(CLOCK_TIMER_HI) = 0;
+    REG_TMCNT(CLOCK_TIMER_HI) = TM_ENABLE | TM_CASCADE;
+    REG_TMCNT(CLOCK_TIMER_LO) = TM_ENABLE | TM_IRQ | TM_FREQ_1;
+}
+
+// Returns the number of CPU cycles since initClock was called
+unsigned int getCycles() {
+    unsigned short hi = REG_TMD(CLOCK_TIMER_HI);
+    unsigned short lo = REG_TMD(CLOCK_TIMER_LO);
+    
+    // If the low timer overflowed between the two reads, the high half we
+    // read is stale. Another overflow is 65536 cycles away, so reading both
+    // halves again is guaranteed to give a consistent pair.
+    if (REG_TMD(CLOCK_TIMER_HI) != hi) {
+        hi = REG_TMD(CLOCK_TIMER_HI);
+        lo = REG_TMD(CLOCK_TIMER_LO);
+    }
+    
+    return ((unsigned int) hi << 16) | lo;
+}
@@ -0,0 +1,16 @@
+// The CPU runs at 2^24 Hz, and the LCD takes 1232 cycles to draw a scanline
+// and 228 scanlines (160 visible + 68 VBlank) to draw a frame
+#define CLOCK_FREQUENCY (1 << 24)
+#define SCANLINE_CYCLES 1232
+#define FRAME_CYCLES (SCANLINE_CYCLES * 228) // 59.73 frames per second
+
+// Timers 2 and 3 are reserved for the clock
+#define CLOCK_TIMER_LO 2
+#define CLOCK_TIMER_HI 3
+
+// Raised every time the low timer overflows (every 65536 cycles, or about 4.3
+// times per frame) for things that need to run at a steady sub-frame rate
+#define CLOCK_OVERFLOW_IRQ IRQ_TIMER(CLOCK_TIMER_LO)
+
+void initClock();
+unsigned int getCycles();
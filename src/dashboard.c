@@ -1,11 +1,13 @@
-#include <stdlib.h>
-#include <stdio.h>
-
 #include "gbalib.h"
 #include "gameboard.h"
 #include "dashboard.h"
 #include "pentomino.h"
 #include "place.h"
+#include "sound.h"
+#include "random.h"
+#include "drawqueue.h"
+#include "render.h"
+#include "save.h"
 
 #include "info/ALERT_WARNING.h"
 #include "info/ALERT_DANGER.h"
@@ -16,7 +18,7 @@
 #include "info/PENTRIS.h"
 
 #define MAX_SCORE_DIGITS 15
-#define SCORE_DIGITS_FORMAT "8"
+#define SCORE_DIGITS 8
 #define BG_COLOR (unsigned short) 0x1084
 
 #define LINE_INDICATOR_TIME 60
@@ -26,26 +28,65 @@
 #define SCORE_AREA_Y 30
 #define NEXT_BOX_X 152
 #define NEXT_BOX_Y 76
+#define PREVIEW_X 136
+#define PREVIEW_Y 121
+#define PREVIEW_SPACING 18
+#define PREVIEW_TILE_PX 3
+#define PREVIEW_SIZE_PX (PREVIEW_TILE_PX * 5)
 #define WARNING_X 132
 #define DANGER_X 137
 #define ALERT_Y 139
 
+// Rough scanline costs of the dashboard's draws, for the draw queue
+#define SCORE_DRAW_LINES 12
+#define NEXT_DRAW_LINES 8
+#define PREVIEW_DRAW_LINES 6
+#define INDICATOR_DRAW_LINES 8
+
 // The player's score
 int score = 0;
-// The next pentomino
-enum TILE nextPentomino = NONE;
+// The upcoming pentominoes, as a ring buffer. The piece at queueHead is shown
+// in the NEXT box, and the PREVIEW_COUNT after it are shown in order, left to
+// right, in small preview slots under it. Popping a piece slides the previews
+// along one slot, so only the last slot has to be drawn from scratch.
+static enum TILE nextQueue[NEXT_QUEUE_SIZE];
+static int queueHead;
+// Where pieces come from. In bag mode, pieces are dealt from a shuffled set of
+// one of each, which is refilled once it runs out.
+static RANDOM pieceRandom;
+static bool bagMode;
+static enum TILE bag[PENTOMINO_TYPES];
+static int bagRemaining;
+
 // Flags to cull unnecessary redrawing
-bool redrawScore = FALSE;
 bool redrawNext = FALSE;
 bool wasInDanger = FALSE;
 bool wasInCritical = FALSE;
+// Pieces popped since the previews were drawn, up to PREVIEW_COUNT for all of
+// them to be drawn again
+static int previewShifts;
 
 // The number of lines that were cleared (used to show a single/double/triple/
 // tetris/pentris indicator)
 int clearedLines;
 // Used to keep track of how long the cleared lines indicator has been shown
-// and to clear it after LINE_INDICATOR_TIME vblanks
+// and to clear it after LINE_INDICATOR_TIME ticks
 int clearedLinesTimer;
+// The cleared lines indicator that should be on screen, and the one that is
+static int bannerLines;
+static int bannerDrawn;
+
+static void _fillBag();
+static enum TILE _generatePiece();
+static POINT _getNextAlignmentOffset(enum TILE tile);
+static void _drawPreview(int slot);
+static void _copyPreview(int from, int to);
+static void _drawScoreArea();
+static void _drawNextBox();
+static void _drawPreviews();
+static void _drawLineClear();
+static bool _hasAlertChanged();
+static void _drawAlerts();
 
 // Called externally to increment the score and redraw it on the next draw cycle
 void incrementScore(int dScore) {
@@ -55,42 +96,139 @@ void incrementScore(int dScore) {
 // Implementaion to set score and redraw it on the next draw cycle
 void setScore(int newScore) {
     score = newScore;
-    redrawScore = TRUE;
+    if (!isRenderPending(RENDER_SCORE)) {
+        renderCommand(RENDER_SCORE, 0);
+    }
 }
 
-// Prepares the next pentomino on the random stack
-void generateNext() {
-    if (redrawNext && isGameStarted()) {
-        return;
+// Starts a new sequence of pieces. The same seed and mode always deal the
+// same pieces.
+void seedPieces(unsigned int seed, bool useBag) {
+    seedRandom(&pieceRandom, seed);
+    bagMode = useBag;
+    bagRemaining = 0;
+}
+
+// Fills the whole queue with new pieces and has all of it drawn. Called once
+// the game's background has been drawn.
+void fillNextQueue() {
+    for (int i = 0; i < NEXT_QUEUE_SIZE; i++) {
+        nextQueue[i] = _generatePiece();
     }
+    queueHead = 0;
     redrawNext = TRUE;
-    // If you want to rig the game, comment these lines out:
-    int random = rand();
-    nextPentomino = random % 18 + 1;
+    previewShifts = PREVIEW_COUNT;
+}
+
+// Packs up the score and the pieces to come to suspend the game. The random
+// state is saved too, so the resumed game deals what this one would have.
+void saveDash(DASH_STATE *state) {
+    state->score = score;
+    state->randomState = pieceRandom.state;
+    for (int i = 0; i < NEXT_QUEUE_SIZE; i++) {
+        state->nextQueue[i] = nextQueue[i];
+    }
+    state->queueHead = queueHead;
+    state->bagMode = bagMode;
+    state->bagRemaining = bagRemaining;
+    for (int i = 0; i < PENTOMINO_TYPES; i++) {
+        state->bag[i] = bag[i];
+    }
+}
+
+// Puts back a suspended game's score and pieces, and has the whole dashboard
+// drawn over the freshly drawn background
+void loadDash(const DASH_STATE *state) {
+    setScore(state->score);
+    pieceRandom.state = state->randomState;
+    for (int i = 0; i < NEXT_QUEUE_SIZE; i++) {
+        nextQueue[i] = state->nextQueue[i];
+    }
+    queueHead = state->queueHead;
+    bagMode = state->bagMode;
+    bagRemaining = state->bagRemaining;
+    for (int i = 0; i < PENTOMINO_TYPES; i++) {
+        bag[i] = state->bag[i];
+    }
     
+    redrawNext = TRUE;
+    previewShifts = PREVIEW_COUNT;
+    wasInDanger = FALSE;
+    wasInCritical = FALSE;
+    clearedLines = 0;
+    clearedLinesTimer = 0;
+    bannerLines = 0;
+    bannerDrawn = 0;
+}
+
+// Picks a random pentomino to go on the end of the queue
+static enum TILE _generatePiece() {
     // If you only want to be given line pieces, uncomment this line:
-    //nextPentomino = I;
-    // If you want to cycle through all the pentominoes, uncomment this line:
-    //nextPentomino = (nextPentomino) % 18 + 1;
+    //return I;
+    
+    if (bagMode) {
+        if (!bagRemaining) {
+            _fillBag();
+        }
+        return bag[--bagRemaining];
+    }
+    return randomBelow(&pieceRandom, PENTOMINO_TYPES) + 1;
+}
+
+// Puts one of each pentomino back in the bag, in a random order
+static void _fillBag() {
+    for (int i = 0; i < PENTOMINO_TYPES; i++) {
+        bag[i] = i + 1;
+    }
+    for (int i = PENTOMINO_TYPES - 1; i > 0; i--) {
+        int j = randomBelow(&pieceRandom, i + 1);
+        enum TILE swap = bag[i];
+        bag[i] = bag[j];
+        bag[j] = swap;
+    }
+    bagRemaining = PENTOMINO_TYPES;
 }
 
 // Called in gameboard.c when lines are cleared so that an accurate lin clear
 // indicator can be drawn on the next draw cycle
 void indicateLineClear() {
     clearedLines++;
+    playSoundEffect(SOUND_LINE_CLEAR);
 }
 
-// Pops the random pentomino stack
+// Called at the end of every game tick to put up the cleared lines indicator
+// for any lines cleared, and to take it down again after a while
+void updateDash() {
+    if (clearedLines) {
+        renderCommand(RENDER_BANNER, clearedLines);
+        clearedLinesTimer = 1;
+        clearedLines = 0;
+    } else if (clearedLinesTimer) {
+        clearedLinesTimer++;
+        if (clearedLinesTimer >= LINE_INDICATOR_TIME) {
+            renderCommand(RENDER_BANNER, 0);
+            clearedLinesTimer = 0;
+        }
+    }
+}
+
+// Pops the piece in the NEXT box off the queue. Its entry is refilled with a
+// new piece, which becomes the last one in the queue.
 enum TILE getNext() {
-    enum TILE next = nextPentomino;
-    generateNext();
+    enum TILE next = nextQueue[queueHead];
+    nextQueue[queueHead] = _generatePiece();
+    if (previewShifts < PREVIEW_COUNT) {
+        previewShifts++;
+    }
+    queueHead = (queueHead + 1) % NEXT_QUEUE_SIZE;
+    redrawNext = TRUE;
     return next;
 }
 
 // Simple switch block to get the line clear sprite for a given number of lines
 // being cleared
-const unsigned short* getLineClearIndicator() {
-    switch(clearedLines) {
+const unsigned short* getLineClearIndicator(int lines) {
+    switch(lines) {
         case 1: return SINGLE_data;
         case 2: return DOUBLE_data;
         case 3: return TRIPLE_data;
@@ -116,9 +254,9 @@ void _clearWarning() {
 // off-center when rendered in the 'next' window. This function is called to
 // return a hard-coded pixel offset to apply to the next pentomino in the random
 // stack to improve the center alignment with the frame.
-POINT _getNextAlignmentOffset() {
+static POINT _getNextAlignmentOffset(enum TILE tile) {
     POINT p = {0, 0};
-    switch (nextPentomino) {
+    switch (tile) {
         case L:
         case N:
             p.x = -4;
@@ -157,61 +295,96 @@ POINT _getNextAlignmentOffset() {
 }
 
 // Handles the magic of dashboard.c. Called in main in the onDraw phase to
-// update all the information in the right panel. Fields that aren't changed
-// are not updated to cull additional drawing work
+// queue drawing for all the information in the right panel. Fields that
+// aren't changed are not updated to cull additional drawing work, and none of
+// it matters enough to hold up the board, so it's all drawn only if there's
+// time left in VBlank.
 void drawDash() {
-    if (redrawScore) {
-        // clear the frame's background
-        drawRect(SCORE_AREA_X, SCORE_AREA_Y, 8, MAX_SCORE_DIGITS * 6, BG_COLOR);
-        drawScore(SCORE_AREA_X, SCORE_AREA_Y);
-        redrawScore = FALSE;
+    if (redrawNext) {
+        queueDraw(_drawNextBox, DRAW_DEFERRABLE, NEXT_DRAW_LINES);
     }
+    if (previewShifts) {
+        queueDraw(_drawPreviews, DRAW_DEFERRABLE, PREVIEW_DRAW_LINES);
+    }
+    if (_hasAlertChanged()) {
+        queueDraw(_drawAlerts, DRAW_DEFERRABLE, INDICATOR_DRAW_LINES);
+    }
+}
 
-    if (redrawNext) {
-        POINT offset = _getNextAlignmentOffset();
-        // clear the frame's background
-        drawRect(NEXT_BOX_X, NEXT_BOX_Y, TILE_SIZE_PX * 5, TILE_SIZE_PX * 5, BG_COLOR);
-        // draw the pentomino preview
-        drawPentominoAtOffset(NEXT_BOX_X + offset.x, NEXT_BOX_Y + offset.y, getPentomino(nextPentomino));
-        redrawNext = FALSE;
+// Has the score redrawn. Run from a render command.
+void showScore() {
+    queueDraw(_drawScoreArea, DRAW_DEFERRABLE, SCORE_DRAW_LINES);
+}
+
+// Has the cleared lines indicator changed to show a number of lines, or taken
+// down for 0. Run from a render command.
+void showBanner(int lines) {
+    bannerLines = lines;
+    queueDraw(_drawLineClear, DRAW_DEFERRABLE, INDICATOR_DRAW_LINES);
+}
+
+static void _drawScoreArea() {
+    // clear the frame's background
+    drawRect(SCORE_AREA_X, SCORE_AREA_Y, 8, MAX_SCORE_DIGITS * 6, BG_COLOR);
+    drawScore(SCORE_AREA_X, SCORE_AREA_Y);
+}
+
+static void _drawNextBox() {
+    enum TILE next = nextQueue[queueHead];
+    POINT offset = _getNextAlignmentOffset(next);
+    // clear the frame's background
+    drawRect(NEXT_BOX_X, NEXT_BOX_Y, TILE_SIZE_PX * 5, TILE_SIZE_PX * 5, BG_COLOR);
+    // draw the pentomino preview
+    drawPentominoAtOffset(NEXT_BOX_X + offset.x, NEXT_BOX_Y + offset.y, getPentomino(next));
+    redrawNext = FALSE;
+}
+
+static void _drawPreviews() {
+    // Slide the previews that are still coming up along to the left, then
+    // draw the pieces that are new at the end
+    for (int slot = 0; slot + previewShifts < PREVIEW_COUNT; slot++) {
+        _copyPreview(slot + previewShifts, slot);
     }
-    
-    if (clearedLines) {
-        if (clearedLinesTimer) {
-            // If there's already an alert happening, and the player is REALLY
-            // good, make sure to erase it before showing another message
-            drawRect(
-                LINE_INDICATOR_X,
-                LINE_INDICATOR_Y,
-                PENTRIS_HEIGHT,
-                PENTRIS_WIDTH,
-                BG_COLOR);
-        }
+    for (int slot = PREVIEW_COUNT - previewShifts; slot < PREVIEW_COUNT; slot++) {
+        _drawPreview(slot);
+    }
+    previewShifts = 0;
+}
+
+static void _drawLineClear() {
+    if (bannerDrawn) {
+        // If there's already an alert happening, and the player is REALLY
+        // good, make sure to erase it before showing another message
+        drawRect(
+            LINE_INDICATOR_X,
+            LINE_INDICATOR_Y,
+            PENTRIS_HEIGHT,
+            PENTRIS_WIDTH,
+            BG_COLOR);
+    }
+    if (bannerLines) {
         // Draw the new cleared line indicator
         drawImage3(
             LINE_INDICATOR_X,
             LINE_INDICATOR_Y,
             PENTRIS_WIDTH,
             PENTRIS_HEIGHT,
-            getLineClearIndicator());
-        
-        // Initialize the timer and reset the cleared lines counter
-        clearedLinesTimer++;
-        clearedLines = 0;
-    } else if (clearedLinesTimer) {
-        // Wait a while before removing the cleared lines indicator
-        clearedLinesTimer++;
-        if (clearedLinesTimer >= LINE_INDICATOR_TIME) {
-            drawRect(
-                LINE_INDICATOR_X,
-                LINE_INDICATOR_Y,
-                PENTRIS_HEIGHT,
-                PENTRIS_WIDTH,
-                BG_COLOR);
-            clearedLinesTimer = 0;
-        }
+            getLineClearIndicator(bannerLines));
     }
-    
+    bannerDrawn = bannerLines;
+}
+
+// Whether the alert shown should change to match how full the board is
+static bool _hasAlertChanged() {
+    if (isInCritical()) {
+        return !wasInCritical;
+    } else if (isInDanger()) {
+        return !wasInDanger || wasInCritical;
+    }
+    return wasInCritical || wasInDanger;
+}
+
+static void _drawAlerts() {
     // Draw alert messages
     if (isInCritical()) {
         // If we're changing alert levels, make sure to clear the previous state
@@ -253,13 +426,48 @@ void drawDash() {
     }
 }
 
+// Draws the piece that's slot + 1 after the one in the NEXT box into its
+// small preview slot
+static void _drawPreview(int slot) {
+    enum TILE tile = nextQueue[(queueHead + 1 + slot) % NEXT_QUEUE_SIZE];
+    int x = PREVIEW_X + slot * PREVIEW_SPACING;
+    POINT offset = _getNextAlignmentOffset(tile);
+    drawRect(x, PREVIEW_Y, PREVIEW_SIZE_PX, PREVIEW_SIZE_PX, BG_COLOR);
+    drawPentominoMini(
+        x + offset.x * PREVIEW_TILE_PX / TILE_SIZE_PX,
+        PREVIEW_Y + offset.y * PREVIEW_TILE_PX / TILE_SIZE_PX,
+        PREVIEW_TILE_PX,
+        getPentomino(tile));
+}
+
+// Copies a preview slot's picture on screen to another slot
+static void _copyPreview(int from, int to) {
+    int fromX = PREVIEW_X + from * PREVIEW_SPACING;
+    int toX = PREVIEW_X + to * PREVIEW_SPACING;
+    for (int y = PREVIEW_Y; y < PREVIEW_Y + PREVIEW_SIZE_PX; y++) {
+        memCopy(&videoBuffer[OFFSET(fromX, y, 240)],
+                &videoBuffer[OFFSET(toX, y, 240)], PREVIEW_SIZE_PX);
+    }
+}
+
 // Used internally and at the game over screen to draw the score to the screen
 void drawScore(int x, int y) {
     // convert the score to a string and print it
-    char buffer[MAX_SCORE_DIGITS];
-    sprintf(buffer, "%0"SCORE_DIGITS_FORMAT"d", score);
+    char buffer[MAX_SCORE_DIGITS + 1];
+    formatDecimal(buffer, score, SCORE_DIGITS);
     drawString(x, y, buffer, WHITE);
 }
 
+// Draws the best score that's been saved, the same way as drawScore
+void drawHighScore(int x, int y) {
+    char buffer[MAX_SCORE_DIGITS + 1];
+    formatDecimal(buffer, getHighScore(0), SCORE_DIGITS);
+    drawString(x, y, buffer, WHITE);
+}
+
+int getScore() {
+    return score;
+}
+
 
 
@@ -1,7 +1,30 @@
+// The NEXT box plus this many more pieces of preview
+#define PREVIEW_COUNT 4
+#define NEXT_QUEUE_SIZE (PREVIEW_COUNT + 1)
+
+// The score and the pieces still to come, packed small for a suspended game
+typedef struct {
+    int score;
+    unsigned int randomState;
+    unsigned char nextQueue[NEXT_QUEUE_SIZE];
+    unsigned char queueHead;
+    unsigned char bagMode;
+    unsigned char bagRemaining;
+    unsigned char bag[PENTOMINO_TYPES];
+} DASH_STATE;
+
 void incrementScore(int dScore);
 void setScore(int score);
-void generateNext();
+void seedPieces(unsigned int seed, bool useBag);
+void fillNextQueue();
 void indicateLineClear();
+void updateDash();
 enum TILE getNext();
 void drawDash();
+void showScore();
+void showBanner(int lines);
 void drawScore();
+void drawHighScore(int x, int y);
+int getScore();
+void saveDash(DASH_STATE *state);
+void loadDash(const DASH_STATE *state);
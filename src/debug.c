@@ -0,0 +1,61 @@
+#include "gbalib.h"
+#include "debug.h"
+
+// Writing the enable key reads back as DEBUG_PRESENT when the emulator has
+// the debug registers. A message in the buffer is sent by writing its log
+// level to the flags.
+#define REG_DEBUG_ENABLE *(volatile unsigned short*) 0x4FFF780
+#define REG_DEBUG_FLAGS  *(volatile unsigned short*) 0x4FFF700
+#define DEBUG_KEY        0xC0DE
+#define DEBUG_PRESENT    0x1DEA
+#define DEBUG_LEVEL_INFO 3
+#define DEBUG_SEND       (1 << 8)
+
+static bool debugPresent;
+
+// Checks for the debug registers, and turns them on if they're there
+bool initDebugLog() {
+    REG_DEBUG_ENABLE = DEBUG_KEY;
+    debugPresent = REG_DEBUG_ENABLE == DEBUG_PRESENT;
+    return debugPresent;
+}
+
+bool hasDebugLog() {
+    return debugPresent;
+}
+
+// Sends whatever is in DEBUG_LOG_BUFFER as one line of the log
+void sendDebugLog() {
+    REG_DEBUG_FLAGS = DEBUG_LEVEL_INFO | DEBUG_SEND;
+}
+
+// Writes value as a fixed number of hex digits, and returns how many
+int writeDebugHex(volatile char *out, unsigned int value, int digits) {
+    for (int i = digits - 1; i >= 0; i--) {
+        int digit = value & 0xF;
+        out[i] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        value >>= 4;
+    }
+    return digits;
+}
+
+// Writes value in decimal with no padding, and returns how many digits
+int writeDebugDecimal(volatile char *out, unsigned int value) {
+    char digits[11];
+    int count = formatDecimal(digits, value, 0);
+    
+    for (int i = 0; i < count; i++) {
+        out[i] = digits[i];
+    }
+    return count;
+}
+
+// Copies a string without its terminator, and returns its length
+int writeDebugString(volatile char *out, const char *str) {
+    int length = 0;
+    while (str[length]) {
+        out[length] = str[length];
+        length++;
+    }
+    return length;
+}
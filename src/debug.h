@@ -0,0 +1,12 @@
+// Logging through mGBA's debug registers. On hardware, or in emulators that
+// don't have them, nothing is logged. A message is written into
+// DEBUG_LOG_BUFFER, null terminated, and then sent with sendDebugLog.
+#define DEBUG_LOG_BUFFER ((volatile char*) 0x4FFF600)
+#define DEBUG_LOG_SIZE 256
+
+bool initDebugLog();
+bool hasDebugLog();
+void sendDebugLog();
+int writeDebugHex(volatile char *out, unsigned int value, int digits);
+int writeDebugString(volatile char *out, const char *str);
+int writeDebugDecimal(volatile char *out, unsigned int value);
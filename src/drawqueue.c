@@ -0,0 +1,196 @@
+#include "gbalib.h"
+#include "clock.h"
+#include "irq.h"
+#include "drawqueue.h"
+
+#define VISIBLE_LINES 160
+#define TOTAL_LINES 228
+// Lines kept free on top of the slowest update seen so far, for the first few
+// frames and for updates a little slower than any yet
+#define RACE_SLACK_LINES 4
+
+typedef struct {
+    drawptr draw;
+    enum DRAW_PRIORITY priority;
+    int lines;
+} DRAW_ITEM;
+
+static DRAW_ITEM queue[DRAW_QUEUE_SIZE];
+static int queueCount;
+// Items that race the raster once the queue is done
+static drawptr raceQueue[RACE_QUEUE_SIZE];
+static int raceCount;
+// Scanlines held back for more important items later in the queue while an
+// item runs (see getDrawBudget)
+static int reservedLines;
+// How many times an item has been put off to a later VBlank
+static int deferredDraws;
+// When the races last finished, and the most cycles the main loop has taken
+// from there until it was ready for the next VBlank. Racing stops early
+// enough to leave that much of the frame.
+static unsigned int racesEndedAt;
+static unsigned int peakUpdateCycles;
+static int raceEndLine = VISIBLE_LINES - RACE_SLACK_LINES;
+
+static int _linesLeft();
+static void _sleepUntilLine(int line);
+
+// Adds an item to this VBlank's drawing. Items are drawn in the order they're
+// queued. An item that's already queued (say, because it was put off from the
+// last VBlank) isn't queued twice.
+void queueDraw(drawptr draw, enum DRAW_PRIORITY priority, int lines) {
+    for (int i = 0; i < queueCount; i++) {
+        if (queue[i].draw == draw) {
+            if (priority < queue[i].priority) {
+                queue[i].priority = priority;
+            }
+            return;
+        }
+    }
+    
+    // Nothing is ever dropped. If the queue is full, just draw it now.
+    if (queueCount == DRAW_QUEUE_SIZE) {
+        draw();
+        return;
+    }
+    
+    queue[queueCount].draw = draw;
+    queue[queueCount].priority = priority;
+    queue[queueCount].lines = lines;
+    queueCount++;
+}
+
+// Adds an item to be run after this VBlank's items. It draws what it can in
+// the rest of the frame by calling waitForRaster before each band it draws,
+// and is dropped from the queue afterwards whether or not it finished.
+void queueRace(drawptr draw) {
+    for (int i = 0; i < raceCount; i++) {
+        if (raceQueue[i] == draw) {
+            return;
+        }
+    }
+    
+    if (raceCount == RACE_QUEUE_SIZE) {
+        return;
+    }
+    raceQueue[raceCount++] = draw;
+}
+
+// Draws the queued items. Each is only drawn if it fits in what's left of
+// VBlank after setting aside time for the more important items queued after
+// it. Whatever doesn't fit stays queued for the next VBlank.
+void runDraws() {
+    int kept = 0;
+    
+    for (int i = 0; i < queueCount; i++) {
+        DRAW_ITEM item = queue[i];
+        
+        reservedLines = 0;
+        for (int j = i + 1; j < queueCount; j++) {
+            if (queue[j].priority < item.priority) {
+                reservedLines += queue[j].lines;
+            }
+        }
+        
+        if (item.lines + reservedLines <= _linesLeft()) {
+            item.draw();
+        } else {
+            queue[kept++] = item;
+            deferredDraws++;
+        }
+    }
+    
+    queueCount = kept;
+    reservedLines = 0;
+}
+
+// Runs the items racing the raster. Called once VBlank's items have been
+// drawn with runDraws, as the last of the frame's work before the next game
+// update.
+void runRaces() {
+    for (int i = 0; i < raceCount; i++) {
+        raceQueue[i]();
+    }
+    raceCount = 0;
+    racesEndedAt = getCycles();
+}
+
+// Called by the main loop once the game update after the races is done and
+// it's about to wait for VBlank. The slowest single tick update so far sets
+// where racing has to stop. Frames that catch up on several ticks have already
+// overrun, so they don't count.
+void finishUpdate(int ticks) {
+    if (ticks != 1) {
+        return;
+    }
+    
+    unsigned int cycles = getCycles() - racesEndedAt;
+    if (cycles > peakUpdateCycles && cycles < FRAME_CYCLES) {
+        peakUpdateCycles = cycles;
+        raceEndLine = VISIBLE_LINES - RACE_SLACK_LINES
+                - (cycles + SCANLINE_CYCLES - 1) / SCANLINE_CYCLES;
+        if (raceEndLine < 0) {
+            raceEndLine = 0;
+        }
+    }
+}
+
+// Sleeps until the display has scanned past screen line bottom, so a band
+// above it can be drawn without tearing. A band is drawn straight away if
+// it'll be done before VBlank ends. Returns FALSE if there isn't time left in
+// this frame to draw it, in which case it should be left for the next VBlank.
+bool waitForRaster(int bottom, int lines) {
+    if (SCANLINECOUNTER >= VISIBLE_LINES) {
+        if (lines <= _linesLeft()) {
+            return TRUE;
+        }
+        _sleepUntilLine(0);
+    }
+    
+    if (bottom + lines > raceEndLine) {
+        return FALSE;
+    }
+    _sleepUntilLine(bottom);
+    return SCANLINECOUNTER + lines <= raceEndLine;
+}
+
+// Throws away anything that was put off, for when the whole screen is about
+// to be redrawn anyway
+void clearDraws() {
+    queueCount = 0;
+    raceCount = 0;
+}
+
+// How many scanlines of VBlank the running item can use. Items that draw a
+// variable amount, like the board, use this to draw as much as fits.
+int getDrawBudget() {
+    return _linesLeft() - reservedLines;
+}
+
+// How many times an item has been put off to a later VBlank
+int getDeferredDraws() {
+    return deferredDraws;
+}
+
+// Halts the CPU until the display is somewhere from screen line line to the
+// end of the visible screen. The VCount interrupt wakes it on that line.
+// Other interrupts can wake it sooner, so it checks again each time.
+static void _sleepUntilLine(int line) {
+    REG_DISPSTAT = (REG_DISPSTAT & ~DISPSTAT_VCOUNT_MASK)
+            | INT_VCOUNT_ENABLE | DISPSTAT_VCOUNT(line);
+    enableInterrupt(IRQ_VCOUNT);
+    while (SCANLINECOUNTER < line || SCANLINECOUNTER >= VISIBLE_LINES) {
+        waitForInterrupt(IRQ_VCOUNT);
+    }
+    disableInterrupt(IRQ_VCOUNT);
+    REG_DISPSTAT &= ~INT_VCOUNT_ENABLE;
+}
+
+// Scanlines until VBlank ends, or 0 if it already has
+static int _linesLeft() {
+    int line = SCANLINECOUNTER;
+    if (line < VISIBLE_LINES) {
+        return 0;
+    }
+    return TOTAL_LINES - line;
+}
@@ -0,0 +1,29 @@
+// Drawing in a frame is queued up as items and then run together in VBlank,
+// so that it can be fit into however much of VBlank is left. Each item has an
+// estimate of how many scanlines it takes to draw. Items that can wait are
+// put off to the next VBlank instead of being drawn while the display is
+// scanning out the screen.
+//
+// Items that draw separate bands of the screen, like the board's rows, can
+// also race the raster: once VBlank's items are done they keep drawing while
+// the display scans out the frame, each band only after the display has
+// passed it, so the change shows up cleanly in the next frame.
+enum DRAW_PRIORITY {
+    DRAW_NORMAL,    // redrawing the board
+    DRAW_DEFERRABLE // dashboard text and alerts
+};
+
+#define DRAW_QUEUE_SIZE 16
+#define RACE_QUEUE_SIZE 4
+
+typedef void (*drawptr)(void);
+
+void queueDraw(drawptr draw, enum DRAW_PRIORITY priority, int lines);
+void queueRace(drawptr draw);
+void runDraws();
+void runRaces();
+void finishUpdate(int ticks);
+bool waitForRaster(int bottom, int lines);
+void clearDraws();
+int getDrawBudget();
+int getDeferredDraws();
@@ -2,6 +2,11 @@
 #include "main.h"
 #include "gameboard.h"
 #include "dashboard.h"
+#include "sound.h"
+#include "trace.h"
+#include "drawqueue.h"
+#include "pentomino.h"
+#include "render.h"
 #include "sprite/TILE_F.h"
 #include "sprite/TILE_F_MIRRORED.h"
 #include "sprite/TILE_I.h"
@@ -22,34 +27,41 @@
 #include "sprite/TILE_Z_MIRRORED.h"
 #include "sprite/TILE_EMPTY.h"
 
-#define ROW_CLEAR_ANIMATION_DURATION 10 // in vblank cycles
+#define ROW_CLEAR_ANIMATION_DURATION 10 // in game ticks
+#define BOARD_ROW_DRAW_LINES 7 // rough scanline cost, for the draw queue
+#define VISIBLE_ROWS_MASK ((1 << BOARD_HEIGHT_VISIBLE) - 1)
 
-// States used when animating row clearing -- also used to pause the game during
-// row clears
-enum ROW_CLEAR_PHASE {
-    INACTIVE,
-    READY,
-    ANIMATE_0,
-    ANIMATE_1,
-    REDRAW
-};
-
-// The number of rows that have been cleared. If this is 1, then we need to
-// pause the game and shift some things down
+// The number of rows that have been filled by the piece being committed
 int clearedRows = 0;
 // Holds the row indices that are full and need to be cleared
 int clearedRowNumbers[5];
 // Holds the number of tiles in each row
 int rowCount[BOARD_HEIGHT];
-// The current phase of the row clearing
-enum ROW_CLEAR_PHASE rowClearPhase;
-// Used to time the row clear animation
-int clearAnimationTimer;
+// Cleared rows are taken off the board as soon as the piece that filled them
+// is committed. On screen, the rows flash white, and the rows above them are
+// left as they were until the flash is over and they're redrawn. The next
+// piece is held back until then, so it never plays on a board the screen
+// isn't showing. These are the rows that are out of date on screen, one bit
+// per row, and how long the flash has left in ticks (0 if there isn't one).
+static int staleRows;
+static int clearAnimationTimer;
+// Board rows that still need to be redrawn, one bit per row. This belongs to
+// the drawing side: update asks for rows with a RENDER_REDRAW_ROWS command.
+static int rowsToRedraw;
 
 // The gameboard is represented as a 2D array. Note that this array should be
 // indexed first by row, then by column (y, x)
 TILE board[BOARD_HEIGHT][BOARD_WIDTH];
 
+// Copies of the tile sprites. They're drawn far more than anything else, and
+// DMA reads them from IWRAM in half the time it takes from ROM.
+static unsigned short tileSprites[PENTOMINO_TYPES + 1][TILE_SIZE_PX * TILE_SIZE_PX];
+
+static void _drawPendingRows();
+static const unsigned short* _romSpriteForType(enum TILE type);
+static void _racePendingRows();
+static void _drawRow(int row);
+
 // Clears the contents of the board to prepare a new game
 void resetBoard() {
     for (int i = 0; i < BOARD_HEIGHT; i++) {
@@ -60,8 +72,9 @@ void resetBoard() {
     }
     
     clearedRows = 0;
-    rowClearPhase = INACTIVE;
+    staleRows = 0;
     clearAnimationTimer = 0;
+    rowsToRedraw = 0;
 }
 
 // Sets a tile on the gameboard and checks for row clearing
@@ -74,37 +87,66 @@ void setTileAtPosition(TILE tile, int x, int y) {
     if (rowCount[y] == BOARD_WIDTH) {
         clearedRowNumbers[clearedRows] = y;
         clearedRows++;
-        rowClearPhase = READY;
         speedUp();
         indicateLineClear();
     }
 }
 
-// Called after tiles have been moved in a game tick to handle row clearing
-void checkRowClear() {
-    if (rowClearPhase == READY) {
-        if (clearedRows) {
-            // give 100 points for clearing a row,
-            // doubling for each additional row
-            incrementScore(100 * (1 << (clearedRows - 1)));
-            rowClearPhase = ANIMATE_0;
-        }
-    } else if (rowClearPhase == ANIMATE_1 && clearAnimationTimer == 3) {
-        // Arraycopy tile data down when we're animating
-        // We do this in the middle of the animation to ensure it runs, and to
-        // ensure we don't waste time by doing it only once
-        for (int i = 0; i < clearedRows; i++) {
-            int r = clearedRowNumbers[i];
-            clearedRowNumbers[i] = 0;
-            for (int j = r - i; j < BOARD_HEIGHT - 3; j++) {
-                rowCount[j] = rowCount[j + 1];
-                for (int k = 0; k < BOARD_WIDTH; k++) {
-                    board[j][k] = board[j + 1][k];
-                }
+// Called once a piece has been committed to take any rows it filled off the
+// board. The rows are flashed on screen, and anything above them is redrawn
+// once the flash is over. Returns TRUE if there's a flash, in which case the
+// next piece has to wait for updateRowClear.
+bool clearFullRows() {
+    if (!clearedRows) {
+        return FALSE;
+    }
+    
+    TRACE_EVENT(TRACE_LINE_CLEAR, clearedRows);
+    // give 100 points for clearing a row,
+    // doubling for each additional row
+    incrementScore(100 * (1 << (clearedRows - 1)));
+    
+    // The rows were filled from the bottom up, so the first is the lowest
+    int flash = 0;
+    for (int i = 0; i < clearedRows; i++) {
+        flash |= 1 << clearedRowNumbers[i];
+    }
+    int lowest = clearedRowNumbers[0];
+    
+    // Arraycopy tile data down over the cleared rows
+    for (int i = 0; i < clearedRows; i++) {
+        int r = clearedRowNumbers[i];
+        clearedRowNumbers[i] = 0;
+        for (int j = r - i; j < BOARD_HEIGHT - 3; j++) {
+            rowCount[j] = rowCount[j + 1];
+            for (int k = 0; k < BOARD_WIDTH; k++) {
+                board[j][k] = board[j + 1][k];
             }
         }
-        clearedRows = 0;
     }
+    clearedRows = 0;
+    
+    renderCommand(RENDER_FLASH_ROWS, flash & VISIBLE_ROWS_MASK);
+    staleRows = VISIBLE_ROWS_MASK & ~((1 << lowest) - 1);
+    clearAnimationTimer = ROW_CLEAR_ANIMATION_DURATION;
+    return TRUE;
+}
+
+// Called every game tick to end the clear animation. Once the rows have
+// flashed for long enough, everything that moved down is redrawn. Returns
+// TRUE on the tick that happens, when the next piece can come in.
+bool updateRowClear() {
+    if (!clearAnimationTimer) {
+        return FALSE;
+    }
+    
+    clearAnimationTimer--;
+    if (clearAnimationTimer) {
+        return FALSE;
+    }
+    renderCommand(RENDER_REDRAW_ROWS, staleRows);
+    staleRows = 0;
+    return TRUE;
 }
 
 // Used after a row is cleared to make sure that all tiles have been drawn in
@@ -117,12 +159,26 @@ void redrawEntireBoard() {
     }
 }
 
-// Called in the onDraw phase of main to animate any row clearings. If there
-// aren't any filled rows, then this function does nothing.
+// Called in the onDraw phase of main to carry on with any rows that still
+// need to be redrawn. Redrawing the whole board takes longer than VBlank, so
+// as many rows are drawn as fit in VBlank, and the rest behind the raster as
+// the display scans down past them. Anything left over waits for the next
+// frame.
 void drawRowClear() {
-    if (rowClearPhase == ANIMATE_0) {
-        for (int i = 0; i < clearedRows; i++) {
-            int r = clearedRowNumbers[i];
+    if (rowsToRedraw) {
+        queueDraw(_drawPendingRows, DRAW_NORMAL, BOARD_ROW_DRAW_LINES);
+        queueRace(_racePendingRows);
+    }
+}
+
+// Flashes board rows white, one bit per row. Run from a render command. A
+// redraw still waiting from earlier would paint over the flash, so the
+// flashing rows are dropped from it. They're out of date on screen now, and
+// are redrawn when the flash is over.
+void flashRows(int mask) {
+    rowsToRedraw &= ~mask;
+    for (int r = 0; r < BOARD_HEIGHT_VISIBLE; r++) {
+        if (mask & (1 << r)) {
             drawRect(
                 BOARD_OFFSET_X_PX,
                 TILE_SIZE_PX * (BOARD_HEIGHT_VISIBLE - r - 1),
@@ -130,23 +186,78 @@ void drawRowClear() {
                 BOARD_WIDTH * TILE_SIZE_PX,
                 WHITE);
         }
-        rowClearPhase = ANIMATE_1;
-    } else if (rowClearPhase == ANIMATE_1) {
-        clearAnimationTimer++;
-        if (clearAnimationTimer >= ROW_CLEAR_ANIMATION_DURATION) {
-            rowClearPhase = REDRAW;
+    }
+}
+
+// Has board rows redrawn from the board, one bit per row. Run from a render
+// command.
+void redrawRows(int mask) {
+    rowsToRedraw |= mask;
+}
+
+// Redraws board rows that are waiting to be, top to bottom, for as long as the
+// draw queue has time. At least one row is drawn every time so the redraw
+// always finishes.
+static void _drawPendingRows() {
+    bool drewRow = FALSE;
+    for (int i = BOARD_HEIGHT_VISIBLE - 1; i >= 0 && rowsToRedraw; i--) {
+        if (!(rowsToRedraw & (1 << i))) {
+            continue;
+        }
+        if (drewRow && getDrawBudget() < BOARD_ROW_DRAW_LINES) {
+            break;
         }
-    } else if (rowClearPhase == REDRAW) {
-        redrawEntireBoard();
-        clearAnimationTimer = 0;
-        rowClearPhase = INACTIVE;
+        _drawRow(i);
+        drewRow = TRUE;
     }
 }
 
-// Let other functions know to pause gameplay for a little bit while we handle
-// row clearing
-bool isClearingRow() {
-    return rowClearPhase != INACTIVE;
+// Redraws the rows VBlank didn't have time for behind the raster
+static void _racePendingRows() {
+    for (int i = BOARD_HEIGHT_VISIBLE - 1; i >= 0 && rowsToRedraw; i--) {
+        if (!(rowsToRedraw & (1 << i))) {
+            continue;
+        }
+        int bottom = TILE_SIZE_PX * (BOARD_HEIGHT_VISIBLE - i);
+        if (!waitForRaster(bottom, BOARD_ROW_DRAW_LINES)) {
+            break;
+        }
+        _drawRow(i);
+    }
+}
+
+// Redraws a board row. The falling piece may have been drawn over it already,
+// so its tiles in this row are put back on top.
+static void _drawRow(int row) {
+    for (int j = 0; j < BOARD_WIDTH; j++) {
+        drawTile(j, row, tileSpriteForType(tileAtPosition(j, row)));
+    }
+    rowsToRedraw &= ~(1 << row);
+    drawPieceOverRow(row);
+}
+
+// Copies the board out to suspend the game
+void saveBoard(unsigned char tiles[BOARD_HEIGHT][BOARD_WIDTH]) {
+    for (int i = 0; i < BOARD_HEIGHT; i++) {
+        for (int j = 0; j < BOARD_WIDTH; j++) {
+            tiles[i][j] = board[i][j];
+        }
+    }
+}
+
+// Puts back a suspended board. The row counts are worked out again from the
+// tiles, and the rows are redrawn like they are after a row clear.
+void loadBoard(unsigned char tiles[BOARD_HEIGHT][BOARD_WIDTH]) {
+    resetBoard();
+    for (int i = 0; i < BOARD_HEIGHT; i++) {
+        for (int j = 0; j < BOARD_WIDTH; j++) {
+            board[i][j] = tiles[i][j];
+            if (board[i][j] != NONE) {
+                rowCount[i]++;
+            }
+        }
+    }
+    renderCommand(RENDER_REDRAW_ROWS, VISIBLE_ROWS_MASK);
 }
 
 // Used to end the game if the last tile didn't go outside the bounds of the
@@ -172,7 +283,7 @@ bool isInCritical() {
 }
 
 // Gets the tile type at a given position. May be NONE.
-enum TILE tileAtPosition(int x, int y) {
+IWRAM_CODE enum TILE tileAtPosition(int x, int y) {
     if (x >= BOARD_WIDTH || x < 0 || y >= BOARD_HEIGHT || y < 0) {
         return NONE;
     }
@@ -181,7 +292,7 @@ enum TILE tileAtPosition(int x, int y) {
 }
 
 // Checks whether there's a tile on the board at a position
-bool hasTileAtPosition(int x, int y) {
+IWRAM_CODE bool hasTileAtPosition(int x, int y) {
     return tileAtPosition(x, y) != NONE;
 }
 
@@ -193,12 +304,28 @@ void drawTile(int x, int y, const unsigned short* tile) {
 
 // Implementation of tile drawing. x and y are pixel offsets with the standard
 // gameboy coordinate scheme
-void drawTileAtPixel(int x, int y, const unsigned short* tile) {
+IWRAM_CODE void drawTileAtPixel(int x, int y, const unsigned short* tile) {
     drawImage3(x, y, TILE_SIZE_PX, TILE_SIZE_PX, tile);
 }
 
+// Copies the tile sprites into IWRAM. Called once at boot.
+void initTileSprites() {
+    for (int i = 0; i <= PENTOMINO_TYPES; i++) {
+        memCopy((void*) _romSpriteForType(i), tileSprites[i],
+                TILE_SIZE_PX * TILE_SIZE_PX);
+    }
+}
+
 // Gets the tile sprite associated with a tile type
 const unsigned short* tileSpriteForType(enum TILE type) {
+    if (type > PENTOMINO_TYPES) {
+        type = NONE;
+    }
+    return tileSprites[type];
+}
+
+// Where each tile sprite is kept in ROM
+static const unsigned short* _romSpriteForType(enum TILE type) {
     switch(type) {
         case F: return TILE_F_data;
         case F_M: return TILE_F_MIRRORED_data;
@@ -31,12 +31,16 @@ typedef enum TILE {
     Z_M = 18
 } TILE;
 
+#define PENTOMINO_TYPES 18 // F to Z_M
+
 void resetBoard();
 void setTileAtPosition(TILE tile, int x, int y);
-void checkRowClear();
+bool clearFullRows();
+bool updateRowClear();
 void redrawEntireBoard();
 void drawRowClear();
-bool isClearingRow();
+void flashRows(int mask);
+void redrawRows(int mask);
 void forceGameOver();
 bool isInDanger();
 bool isInCritical();
@@ -44,5 +48,8 @@ bool isGameOver();
 enum TILE tileAtPosition(int x, int y);
 bool hasTileAtPosition(int x, int y);
 void drawTile(int x, int y, const unsigned short* tile);
+void initTileSprites();
 const unsigned short* tileSpriteForType(enum TILE type);
 void drawTileAtPixel(int x, int y, const unsigned short* tile);
+void saveBoard(unsigned char tiles[BOARD_HEIGHT][BOARD_WIDTH]);
+void loadBoard(unsigned char tiles[BOARD_HEIGHT][BOARD_WIDTH]);
@@ -6,7 +6,7 @@ void setPixel(int x, int y, unsigned short color) {
     videoBuffer[OFFSET(x, y, 240)] = color;
 }
 
-void drawRect(int x, int y, int height, int width, volatile unsigned short color) {
+IWRAM_CODE void drawRect(int x, int y, int height, int width, volatile unsigned short color) {
     for (int i = 0; i < height; i++) {
         memFill((void*) &color, &videoBuffer[x + (y + i) * 240], width);
     }
@@ -17,11 +17,38 @@ void waitForVblank() {
     while (SCANLINECOUNTER < 160);
 }
 
+// Stops the CPU with the BIOS Halt call until an interrupt enabled in REG_IE
+// is raised. That's whether or not REG_IME is on. The SWI number sits in a
+// different place in Thumb and ARM code.
+void halt() {
+#ifdef __thumb__
+    __asm__ volatile ("swi 0x02" ::: "r0", "r1", "r2", "r3", "memory");
+#else
+    __asm__ volatile ("swi 0x020000" ::: "r0", "r1", "r2", "r3", "memory");
+#endif
+}
+
+// Halts the CPU with the BIOS IntrWait call until one of irqs has been handled.
+// The dispatcher in irq.s marks each interrupt it handles for this, so unlike
+// a bare halt, an interrupt that comes in just before the call isn't slept
+// through. REG_IME has to be on.
+void waitForInterrupt(int irqs) {
+    register int discardOld __asm__("r0") = FALSE;
+    register int flags __asm__("r1") = irqs;
+#ifdef __thumb__
+    __asm__ volatile ("swi 0x04" : "+r" (discardOld), "+r" (flags)
+            :: "r2", "r3", "memory");
+#else
+    __asm__ volatile ("swi 0x040000" : "+r" (discardOld), "+r" (flags)
+            :: "r2", "r3", "memory");
+#endif
+}
+
 void drawScreen(const unsigned short* image) {
     memCopy((void*) image, videoBuffer, 240 * 160);
 }
 
-void drawImage3(int x, int y, int width, int height, const unsigned short* image) {
+IWRAM_CODE void drawImage3(int x, int y, int width, int height, const unsigned short* image) {
     if (x == 0 && y == 0 && width == 240 && height == 160) {
         drawScreen(image);
     } else {
@@ -37,7 +64,7 @@ void drawImage3(int x, int y, int width, int height, const unsigned short* image
     }
 }
 
-void memCopy(void* src, void* dest, int size) {
+IWRAM_CODE void memCopy(void* src, void* dest, int size) {
     DMA[DMA_CHANNEL_3].src = src;
     DMA[DMA_CHANNEL_3].dst = dest;
     DMA[DMA_CHANNEL_3].cnt = size 
@@ -46,7 +73,7 @@ void memCopy(void* src, void* dest, int size) {
         | DMA_ON;
 }
 
-void memFill(void* fill, void* dest, int size) {
+IWRAM_CODE void memFill(void* fill, void* dest, int size) {
     DMA[DMA_CHANNEL_3].src = fill;
     DMA[DMA_CHANNEL_3].dst = dest;
     DMA[DMA_CHANNEL_3].cnt = size 
@@ -91,3 +118,25 @@ void drawString(int x, int y, char *str, unsigned short color) {
         x += 6;
     }
 }
+
+// Writes a number in decimal, padded with zeros to at least minDigits, and
+// null terminates it. Returns the number of digits written. out needs room
+// for 10 digits (or minDigits) plus the terminator.
+int formatDecimal(char *out, unsigned int value, int minDigits) {
+    char digits[10];
+    int count = 0;
+    do {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    
+    int length = 0;
+    for (int i = count; i < minDigits; i++) {
+        out[length++] = '0';
+    }
+    while (count) {
+        out[length++] = digits[--count];
+    }
+    out[length] = '\0';
+    return length;
+}
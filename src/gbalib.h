@@ -9,6 +9,14 @@ typedef unsigned char bool;
 
 #define SCANLINECOUNTER *(volatile unsigned short *)0x4000006 
 
+// The display can raise an interrupt at the start of VBlank, or when it gets
+// to the line set with DISPSTAT_VCOUNT
+#define REG_DISPSTAT        *(volatile unsigned short*)0x4000004
+#define INT_VBLANK_ENABLE   (1 << 3)
+#define INT_VCOUNT_ENABLE   (1 << 5)
+#define DISPSTAT_VCOUNT(line) ((line) << 8)
+#define DISPSTAT_VCOUNT_MASK  (0xFF << 8)
+
 extern unsigned short *videoBuffer;
 
 #define COLOR(r, g, b)  ((r) | (g)<<5 | (b)<<10)
@@ -41,6 +49,77 @@ extern unsigned short *videoBuffer;
 
 #define BUTTONS *(volatile unsigned int *)0x4000130
 
+// Raises IRQ_KEYPAD while any of the buttons in the low bits are down
+#define REG_KEYCNT *(volatile unsigned short *)0x4000132
+#define KEYCNT_IRQ (1<<14)
+
+// Color special effects. BLD_DARKEN fades the layers picked in REG_BLDCNT
+// toward black by REG_BLDY sixteenths.
+#define REG_BLDCNT *(volatile unsigned short *)0x4000050
+#define REG_BLDY   *(volatile unsigned short *)0x4000054
+#define BLD_BG2    (1<<2)
+#define BLD_BD     (1<<5)
+#define BLD_DARKEN (3<<6)
+
+// Interrupts
+#define REG_IE  *(volatile unsigned short*) 0x4000200
+#define REG_IF  *(volatile unsigned short*) 0x4000202
+#define REG_IME *(volatile unsigned short*) 0x4000208
+#define IRQ_ENABLE    1
+#define IRQ_VBLANK    (1 << 0)
+#define IRQ_HBLANK    (1 << 1)
+#define IRQ_VCOUNT    (1 << 2)
+#define IRQ_TIMER(n)  (1 << (3 + (n))) /* 0, 1, 2 or 3 */
+#define IRQ_COM       (1 << 7)
+#define IRQ_DMA(n)    (1 << (8 + (n)))
+#define IRQ_KEYPAD    (1 << 12)
+#define IRQ_CARTRIDGE (1 << 13)
+typedef void (*irqptr)(void);
+#define REG_ISR_MAIN *(volatile irqptr*) 0x3007FFC
+#define REG_IFBIOS   *(volatile unsigned short*) 0x3007FF8
+#define IRQ_COUNT     14
+
+// Timers
+#define REG_TMD(n)   *(volatile unsigned short*)(0x4000100 + ((n) << 2))
+#define REG_TMCNT(n) *(volatile unsigned short*)(0x4000102 + ((n) << 2))
+#define TM_FREQ_1    0
+#define TM_FREQ_64   1
+#define TM_FREQ_256  2
+#define TM_FREQ_1024 3
+#define TM_CASCADE   (1 << 2)
+#define TM_IRQ       (1 << 6)
+#define TM_ENABLE    (1 << 7)
+
+// Memory sections. Zeroed data too big for the 32K of IWRAM can go in the
+// 256K of EWRAM instead. Global variables are in IWRAM unless they say
+// otherwise.
+#define EWRAM_BSS __attribute__((section(".sbss")))
+
+// Code is Thumb and runs from ROM, which is only 16 bits wide, unless it's
+// marked IWRAM_CODE. IWRAM code is copied to IWRAM at boot and compiled as
+// ARM, since IWRAM fetches 32 bits at a time with no wait states. It's for
+// the few functions that run often. ROM_ONLY builds leave everything in ROM.
+// Calls between ROM and IWRAM are out of branch range, but every call is
+// already a long call (-mlong-calls in the Makefile), so the prototypes
+// don't need to say anything.
+#ifdef ROM_ONLY
+#define IWRAM_CODE
+#else
+#define IWRAM_CODE __attribute__((section(".iwram"), target("arm")))
+#endif
+
+// Cartridge wait states. The default at boot is the slowest for everything
+// (4 cycles for the first ROM access, 2 after that) with no prefetch. Game
+// Paks are all fast enough for 3 and 1, and the prefetch buffer fetches ROM
+// ahead whenever the CPU isn't using the bus. SRAM stays at 8 cycles.
+#define REG_WAITCNT *(volatile unsigned short*) 0x4000204
+#define WAITCNT_SRAM_8      3
+#define WAITCNT_ROM_3_1     ((1 << 2) | (1 << 4))
+#define WAITCNT_WS2_8_8     (3 << 8)
+#define WAITCNT_PREFETCH    (1 << 14)
+#define WAITCNT_FAST (WAITCNT_SRAM_8 | WAITCNT_ROM_3_1 | WAITCNT_WS2_8_8 \
+        | WAITCNT_PREFETCH) // 0x4317
+
 /* DMA */
 
 #define REG_DMA0SAD         *(const volatile u32*)0x40000B0 // source address
@@ -103,6 +182,8 @@ typedef struct
 void setPixel(int r, int c, unsigned short color);
 void drawRect(int row, int col, int height, int width, volatile unsigned short color);
 void waitForVblank();
+void halt();
+void waitForInterrupt(int irqs);
 void drawImage3(int x, int y, int width, int height, const unsigned short* image);
 void memCopy(void* src, void* dest, int size);
 void memFill(void* fill, void* dest, int size);
@@ -113,3 +194,4 @@ extern const unsigned char fontdata_6x8[12288];
 
 void drawChar(int x, int y, char ch, unsigned short color);
 void drawString(int x, int y, char *str, unsigned short color);
+int formatDecimal(char *out, unsigned int value, int minDigits);
@@ -0,0 +1,220 @@
+#include "gbalib.h"
+#include "clock.h"
+#include "irq.h"
+#include "input.h"
+
+#define BUTTON_COUNT 10
+
+// Bit positions of the buttons that auto-repeat, used to index heldTicks
+#define INDEX_RIGHT 4
+#define INDEX_LEFT  5
+#define INDEX_DOWN  7
+
+typedef struct {
+    enum ACTION action;
+    unsigned int time;
+} QUEUED_ACTION;
+
+// Button changes recorded by the sampler interrupt. The interrupt is the only
+// thing that moves the head and the game tick is the only thing that moves
+// the tail, so neither side needs a lock to share the queue.
+static volatile BUTTON_EVENT eventQueue[BUTTON_EVENT_QUEUE_SIZE];
+static volatile int eventHead;
+static volatile int eventTail;
+// The last button state the sampler saw
+static unsigned short sampledButtons;
+
+// Buttons that are down as of the last event handled in this tick, and
+// buttons that went down at any point during this tick
+static unsigned int currentButtons;
+static unsigned int pressedButtons;
+
+// How many ticks each button has been held for (0 if it's up)
+static int heldTicks[BUTTON_COUNT];
+
+// Auto-repeat timing for held directions
+static int autoShiftDelay = DEFAULT_DAS;
+static int autoRepeatRate = DEFAULT_ARR;
+
+// Actions waiting to be handled by the game tick, in the order they happened
+static QUEUED_ACTION actionQueue[ACTION_QUEUE_SIZE];
+static int actionHead;
+static int actionTail;
+static unsigned int lastActionTime;
+
+static void _sampleButtons();
+static void _handleEvent(unsigned short buttons, unsigned int time);
+static void _pushAction(enum ACTION action, unsigned int time);
+static void _pushRepeatingAction(int buttonIndex, enum ACTION action,
+        unsigned int time);
+
+// Resets all button state and starts sampling the buttons several times per
+// frame. The clock's interrupt is shared (see sampler.c), so its handler is
+// only set here, once at startup.
+void initInput() {
+    resetInput();
+    setInterruptHandler(CLOCK_OVERFLOW_IRQ, _sampleButtons);
+    enableInterrupt(CLOCK_OVERFLOW_IRQ);
+}
+
+// Forgets everything the buttons have done, as after a pause. Every button is
+// treated as held so that whatever was pressed to get here doesn't
+// immediately count as a new press.
+void resetInput() {
+    // The sampler interrupt moves the head of the event queue
+    unsigned short ime = REG_IME;
+    REG_IME &= ~IRQ_ENABLE;
+    sampledButtons = BUTTON_ANY;
+    currentButtons = BUTTON_ANY;
+    pressedButtons = 0;
+    eventHead = 0;
+    eventTail = 0;
+    REG_IME = ime;
+    
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        heldTicks[i] = 0;
+    }
+    clearActions();
+}
+
+// Turns everything that happened to the buttons since the last game tick into
+// actions, in the order it happened
+void updateInput() {
+    // Take one last sample so the tick sees the buttons as they are right now.
+    // Interrupts are held off so the sampler doesn't run in the middle of it.
+    REG_IME &= ~IRQ_ENABLE;
+    _sampleButtons();
+    REG_IME |= IRQ_ENABLE;
+    
+    pressedButtons = 0;
+    while (eventTail != eventHead) {
+        volatile BUTTON_EVENT *event = &eventQueue[eventTail];
+        _handleEvent(event->buttons, event->time);
+        eventTail = (eventTail + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+    }
+    
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        if (currentButtons & (1 << i)) {
+            heldTicks[i]++;
+        } else {
+            heldTicks[i] = 0;
+        }
+    }
+    
+    // Held directions repeat on tick boundaries
+    unsigned int now = getCycles();
+    _pushRepeatingAction(INDEX_LEFT, ACTION_MOVE_LEFT, now);
+    _pushRepeatingAction(INDEX_RIGHT, ACTION_MOVE_RIGHT, now);
+    _pushRepeatingAction(INDEX_DOWN, ACTION_SOFT_DROP, now);
+}
+
+// Returns true if a button went down in this tick (and only in this tick)
+bool keyPressStart(int button) {
+    return (pressedButtons & button) != 0;
+}
+
+// Returns true if a button is currently down
+bool keyHeld(int button) {
+    return (currentButtons & button) != 0;
+}
+
+// Changes how long a direction must be held before it repeats, and how often
+// it repeats after that. Both are in game ticks.
+void setAutoRepeat(int das, int arr) {
+    // A button has been held for 1 tick on the tick it went down, which
+    // already moved the piece once
+    autoShiftDelay = das > 1 ? das : 2;
+    autoRepeatRate = arr > 0 ? arr : 1;
+}
+
+// Takes the oldest action off the queue, or ACTION_NONE if it's empty
+enum ACTION popAction() {
+    if (actionHead == actionTail) {
+        return ACTION_NONE;
+    }
+    enum ACTION action = actionQueue[actionTail].action;
+    lastActionTime = actionQueue[actionTail].time;
+    actionTail = (actionTail + 1) & (ACTION_QUEUE_SIZE - 1);
+    return action;
+}
+
+// The clock reading of the button change behind the last popped action
+unsigned int getLastActionTime() {
+    return lastActionTime;
+}
+
+// Throws away any actions that haven't been handled yet
+void clearActions() {
+    actionHead = 0;
+    actionTail = 0;
+}
+
+// Called from the clock's overflow interrupt (and once per tick) to record
+// any change in the buttons. If the queue is full, the change is left for the
+// next sample to pick up rather than lost.
+static void _sampleButtons() {
+    unsigned short buttons = ~BUTTONS & BUTTON_ANY;
+    if (buttons == sampledButtons) {
+        return;
+    }
+    
+    int next = (eventHead + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+    if (next != eventTail) {
+        eventQueue[eventHead].time = getCycles();
+        eventQueue[eventHead].buttons = buttons;
+        eventHead = next;
+        sampledButtons = buttons;
+    }
+}
+
+// Queues the actions for every button that went down in a single event. The
+// order here decides what wins when buttons go down together: rotate before
+// moving, and drop last, which is what a player pressing them together
+// expects.
+static void _handleEvent(unsigned short buttons, unsigned int time) {
+    unsigned int pressed = buttons & ~currentButtons;
+    currentButtons = buttons;
+    pressedButtons |= pressed;
+    
+    if (pressed & BUTTON_R) {
+        _pushAction(ACTION_ROTATE_CW, time);
+    }
+    if (pressed & BUTTON_L) {
+        _pushAction(ACTION_ROTATE_CCW, time);
+    }
+    if (pressed & BUTTON_LEFT) {
+        _pushAction(ACTION_MOVE_LEFT, time);
+    }
+    if (pressed & BUTTON_RIGHT) {
+        _pushAction(ACTION_MOVE_RIGHT, time);
+    }
+    if (pressed & BUTTON_DOWN) {
+        _pushAction(ACTION_SOFT_DROP, time);
+    }
+    if (pressed & BUTTON_A) {
+        _pushAction(ACTION_HARD_DROP, time);
+    }
+}
+
+// Adds an action to the queue. If the game has fallen so far behind that the
+// queue is full, the action is dropped.
+static void _pushAction(enum ACTION action, unsigned int time) {
+    int next = (actionHead + 1) & (ACTION_QUEUE_SIZE - 1);
+    if (next != actionTail) {
+        actionQueue[actionHead].action = action;
+        actionQueue[actionHead].time = time;
+        actionHead = next;
+    }
+}
+
+// Queues an action once its button has been held for the auto-shift delay,
+// then again at the auto-repeat rate. The first press is queued by
+// _handleEvent.
+static void _pushRepeatingAction(int buttonIndex, enum ACTION action,
+        unsigned int time) {
+    int held = heldTicks[buttonIndex];
+    if (held >= autoShiftDelay
+            && (held - autoShiftDelay) % autoRepeatRate == 0) {
+        _pushAction(action, time);
+    }
+}
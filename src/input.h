@@ -0,0 +1,36 @@
+// Default auto-repeat timing for held directions, in game ticks
+#define DEFAULT_DAS 10 // delay before a held direction starts repeating
+#define DEFAULT_ARR 2  // delay between each repeat after that
+
+// Both must be powers of two
+#define ACTION_QUEUE_SIZE 16
+#define BUTTON_EVENT_QUEUE_SIZE 32
+
+// Things the player can ask the falling piece to do
+enum ACTION {
+    ACTION_NONE,
+    ACTION_MOVE_LEFT,
+    ACTION_MOVE_RIGHT,
+    ACTION_SOFT_DROP,
+    ACTION_HARD_DROP,
+    ACTION_ROTATE_CW,
+    ACTION_ROTATE_CCW,
+    ACTION_COUNT
+};
+
+// A change in the buttons, stamped with the clock reading it was seen at.
+// buttons has a bit set for every button that's down.
+typedef struct {
+    unsigned int time;
+    unsigned short buttons;
+} BUTTON_EVENT;
+
+void initInput();
+void resetInput();
+void updateInput();
+bool keyPressStart(int button);
+bool keyHeld(int button);
+void setAutoRepeat(int das, int arr);
+enum ACTION popAction();
+unsigned int getLastActionTime();
+void clearActions();
@@ -0,0 +1,98 @@
+#include "gbalib.h"
+#include "irq.h"
+
+// One handler per interrupt source, indexed by the source's bit in REG_IE.
+// These are read by the dispatcher in irq.s.
+irqptr irqHandlers[IRQ_COUNT];
+// Sources whose handlers can be interrupted by other interrupts
+unsigned short irqNestable;
+// The address of the instruction the latest interrupt cut in before
+unsigned int irqInterruptedPc;
+
+void irqDispatch();
+
+// Takes ownership of the interrupt vector. Anything that needs an interrupt
+// registers a handler here instead of replacing REG_ISR_MAIN, so that several
+// parts of the game can share interrupts without clobbering each other.
+void initInterrupts() {
+    REG_IME &= ~IRQ_ENABLE;
+    for (int i = 0; i < IRQ_COUNT; i++) {
+        irqHandlers[i] = 0;
+    }
+    irqNestable = 0;
+    REG_IE = 0;
+    REG_IF = 0xFFFF;
+    REG_ISR_MAIN = irqDispatch;
+    REG_IME |= IRQ_ENABLE;
+}
+
+// Sets the function to call when an interrupt fires. irq is one of the IRQ_*
+// bits. The source still has to be enabled with enableInterrupt, and the
+// hardware that raises it (a timer, the display, ...) has to be told to.
+void setInterruptHandler(int irq, irqptr handler) {
+    for (int i = 0; i < IRQ_COUNT; i++) {
+        if (irq & (1 << i)) {
+            irqHandlers[i] = handler;
+        }
+    }
+}
+
+// Gets the function called when irq fires, so that a new handler can pass
+// the interrupt on to the old one
+irqptr getInterruptHandler(int irq) {
+    for (int i = 0; i < IRQ_COUNT; i++) {
+        if (irq & (1 << i)) {
+            return irqHandlers[i];
+        }
+    }
+    return 0;
+}
+
+// Lets other interrupts fire while the handler for irq runs. This is for long
+// handlers that shouldn't hold up short, time critical ones. A nestable handler
+// can be interrupted by any source, including its own if it runs long enough
+// for that to fire again.
+void setInterruptNesting(int irq, bool nestable) {
+    if (nestable) {
+        irqNestable |= irq;
+    } else {
+        irqNestable &= ~irq;
+    }
+}
+
+// The address the CPU was at when the interrupt being handled right now
+// fired. Only meaningful from inside a handler.
+unsigned int getInterruptedPc() {
+    return irqInterruptedPc;
+}
+
+void enableInterrupt(int irq) {
+    REG_IE |= irq;
+}
+
+void disableInterrupt(int irq) {
+    REG_IE &= ~irq;
+}
+
+// Halts the CPU until one of the buttons is pressed. Every other interrupt is
+// held off until then, so nothing else wakes it up, and anything they raised
+// while asleep is thrown away. Whoever sleeps should first stop anything that
+// can't miss an interrupt, like the music. The keypad wakes the CPU even with
+// REG_IME off, so there's no handler for it.
+void sleepUntilKeys(int buttons) {
+    unsigned short ime = REG_IME;
+    unsigned short ie = REG_IE;
+    REG_IME &= ~IRQ_ENABLE;
+    REG_IE = IRQ_KEYPAD;
+    REG_KEYCNT = KEYCNT_IRQ | buttons;
+    
+    do {
+        REG_IF = IRQ_KEYPAD;
+        halt();
+    } while (!KEY_DOWN_NOW(buttons));
+    
+    REG_KEYCNT = 0;
+    REG_IF = 0xFFFF;
+    REG_IE = ie;
+    REG_IME = ime;
+}
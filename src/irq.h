@@ -0,0 +1,8 @@
+void initInterrupts();
+void setInterruptHandler(int irq, irqptr handler);
+irqptr getInterruptHandler(int irq);
+void setInterruptNesting(int irq, bool nestable);
+void enableInterrupt(int irq);
+void disableInterrupt(int irq);
+unsigned int getInterruptedPc();
+void sleepUntilKeys(int buttons);
@@ -0,0 +1,78 @@
+@ The interrupt dispatcher. The BIOS calls this for every interrupt, in IRQ
+@ mode and ARM state, with r0-r3, r12 and lr already saved on the IRQ stack.
+@ It lives in IWRAM and is ARM code so that it runs at full speed without
+@ waiting on the ROM.
+@
+@ One source is handled per call, lowest bit (highest priority) first, and
+@ only that source is acknowledged. Anything else still pending brings the
+@ CPU straight back here once the handler returns, so every source gets the
+@ same short path to its handler. Handlers run in system mode on the main
+@ stack, with interrupts left on for sources marked nestable in irq.c.
+
+    .section .iwram, "ax", %progbits
+    .arm
+    .align 2
+    .global irqDispatch
+    .type irqDispatch, %function
+irqDispatch:
+    mov     r0, #0x4000000
+    ldr     r1, [r0, #0x200]        @ REG_IE in the low half, REG_IF above
+    ands    r1, r1, r1, lsr #16     @ enabled sources that fired
+    bxeq    lr
+    
+    @ Note what was interrupted, for the sampling profiler. The BIOS saved
+    @ the return address, 4 past it, last on the IRQ stack.
+    ldr     r2, [sp, #20]
+    sub     r2, r2, #4
+    ldr     r3, =irqInterruptedPc
+    str     r2, [r3]
+    rsb     r2, r1, #0
+    and     r1, r1, r2              @ just the highest priority one
+    
+    @ Acknowledge it, and let the BIOS know in case IntrWait is waiting on it.
+    @ REG_IFBIOS at 0x3007FF8 is mirrored just below the I/O registers.
+    add     r3, r0, #0x200
+    strh    r1, [r3, #2]
+    ldrh    r2, [r0, #-8]
+    orr     r2, r2, r1
+    strh    r2, [r0, #-8]
+    
+    @ Find its handler
+    ldr     r12, =irqHandlers
+    mov     r2, r1
+1:  movs    r2, r2, lsr #1
+    addne   r12, r12, #4
+    bne     1b
+    ldr     r12, [r12]
+    cmp     r12, #0
+    bxeq    lr
+    
+    ldr     r3, =irqNestable
+    ldrh    r3, [r3]
+    tst     r3, r1
+    
+    @ Keep the IRQ mode state safe from a nested interrupt, then switch to
+    @ system mode, turning interrupts back on if this source can be nested
+    mrs     r2, spsr
+    stmfd   sp!, {r2, lr}
+    mrs     r2, cpsr
+    orr     r2, r2, #0x1F
+    bicne   r2, r2, #0x80
+    msr     cpsr_c, r2
+    
+    stmfd   sp!, {lr}
+    mov     lr, pc
+    bx      r12
+    ldmfd   sp!, {lr}
+    
+    @ Back to IRQ mode with interrupts off, and return to the BIOS
+    mrs     r2, cpsr
+    bic     r2, r2, #0x1F
+    orr     r2, r2, #0x92
+    msr     cpsr_c, r2
+    ldmfd   sp!, {r2, lr}
+    msr     spsr_cxsf, r2
+    bx      lr
+    
+    .size irqDispatch, . - irqDispatch
+    .pool
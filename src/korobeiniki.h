@@ -1,22 +1,23 @@
 
 /**************************************************************
  *    
- *    korobeiniki, 8 bit, 22050Hz,
- *    1 channel, 850777 bytes/channel
- *    Total Size: 1 * 850777 + 4 (header) = 851069 bytes
+ *    korobeiniki, 4 bit IMA ADPCM, 21024Hz,
+ *    1 channel, 809499 samples in 2300 blocks of 352
+ *    Total Size: 2300 * 180 = 414000 bytes
  *    
- *    Generated by wav2c v1.0 from:
+ *    Generated by tools/wav2adpcm.py from:
  *    korobeiniki.wav
- *    Time-stamp: Thu Mar 31 19:39:06 2016
  *    
  **************************************************************/
 
 #ifndef __KOROBEINIKIH__
 #define __KOROBEINIKIH__
 
-#define KOROBEINIKIFREQ 22050
-#define KOROBEINIKILEN 849000
+#define KOROBEINIKI_RATE 21024
+#define KOROBEINIKI_LENGTH 809499
+#define KOROBEINIKI_BLOCK_SAMPLES 352
+#define KOROBEINIKI_BLOCKS 2300
 
-extern const unsigned char korobeiniki[850777];
+extern const unsigned char korobeiniki[414000];
 
 #endif /* __KOROBEINIKIH__ */
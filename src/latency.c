@@ -0,0 +1,154 @@
+#include "gbalib.h"
+#include "clock.h"
+#include "gameboard.h"
+#include "input.h"
+#include "debug.h"
+#include "latency.h"
+
+#define SCANLINES 228
+
+typedef struct {
+    enum ACTION action;
+    unsigned int edgeTime;
+    int scanline;
+} PENDING_ACTION;
+
+static const char *actionNames[ACTION_COUNT] = {
+    "none",
+    "move-left",
+    "move-right",
+    "soft-drop",
+    "hard-drop",
+    "rotate-cw",
+    "rotate-ccw"
+};
+
+// Actions that have been handled but not drawn yet
+static PENDING_ACTION pending[LATENCY_PENDING];
+static int pendingCount;
+
+// Latencies per action, in scanlines
+static unsigned short histogram[ACTION_COUNT][LATENCY_BUCKETS];
+static unsigned int samples[ACTION_COUNT];
+static unsigned int totalLines[ACTION_COUNT];
+static unsigned int minLines[ACTION_COUNT];
+static unsigned int maxLines[ACTION_COUNT];
+
+static void _record(enum ACTION action, unsigned int lines);
+static void _clearLatency();
+
+// Called when an action has changed the piece. row is the board row the
+// change shows up at, which decides when the raster gets to it.
+void noteLatencyAction(enum ACTION action, int row) {
+    if (pendingCount == LATENCY_PENDING) {
+        return;
+    }
+    
+    int scanline = TILE_SIZE_PX * (BOARD_HEIGHT_VISIBLE - 1 - row);
+    if (scanline < 0) {
+        scanline = 0;
+    }
+    
+    pending[pendingCount].action = action;
+    pending[pendingCount].edgeTime = getLastActionTime();
+    pending[pendingCount].scanline = scanline;
+    pendingCount++;
+}
+
+// Called once the piece has been drawn to VRAM. Each pending action is timed
+// up to the next time the display scans out its row, since that's when the
+// change can actually be seen.
+void noteLatencyDrawn() {
+    unsigned int written = getCycles();
+    int line = SCANLINECOUNTER;
+    
+    for (int i = 0; i < pendingCount; i++) {
+        int wait = (pending[i].scanline - line + SCANLINES) % SCANLINES;
+        unsigned int lines = (written - pending[i].edgeTime) / SCANLINE_CYCLES
+                + wait;
+        _record(pending[i].action, lines);
+    }
+    pendingCount = 0;
+}
+
+// Writes each action's histogram to the debug log and starts over. Each
+// action gets a summary line, then a line per bucket that was hit, with
+// latencies in scanlines (228 to a frame).
+void dumpLatency() {
+    if (hasDebugLog()) {
+        for (int a = 1; a < ACTION_COUNT; a++) {
+            if (!samples[a]) {
+                continue;
+            }
+            
+            volatile char *out = DEBUG_LOG_BUFFER;
+            out += writeDebugString(out, "latency ");
+            out += writeDebugString(out, actionNames[a]);
+            out += writeDebugString(out, " n=");
+            out += writeDebugDecimal(out, samples[a]);
+            out += writeDebugString(out, " min=");
+            out += writeDebugDecimal(out, minLines[a]);
+            out += writeDebugString(out, " mean=");
+            out += writeDebugDecimal(out, totalLines[a] / samples[a]);
+            out += writeDebugString(out, " max=");
+            out += writeDebugDecimal(out, maxLines[a]);
+            *out = '\0';
+            sendDebugLog();
+            
+            for (int b = 0; b < LATENCY_BUCKETS; b++) {
+                if (!histogram[a][b]) {
+                    continue;
+                }
+                out = DEBUG_LOG_BUFFER;
+                out += writeDebugString(out, "latency ");
+                out += writeDebugString(out, actionNames[a]);
+                *out++ = ' ';
+                out += writeDebugDecimal(out, b * LATENCY_BUCKET_LINES);
+                if (b == LATENCY_BUCKETS - 1) {
+                    *out++ = '+';
+                } else {
+                    *out++ = '-';
+                    out += writeDebugDecimal(out,
+                            (b + 1) * LATENCY_BUCKET_LINES - 1);
+                }
+                *out++ = ' ';
+                out += writeDebugDecimal(out, histogram[a][b]);
+                *out = '\0';
+                sendDebugLog();
+            }
+        }
+    }
+    _clearLatency();
+}
+
+static void _record(enum ACTION action, unsigned int lines) {
+    int bucket = lines / LATENCY_BUCKET_LINES;
+    if (bucket >= LATENCY_BUCKETS) {
+        bucket = LATENCY_BUCKETS - 1;
+    }
+    if (histogram[action][bucket] < 0xFFFF) {
+        histogram[action][bucket]++;
+    }
+    
+    if (!samples[action] || lines < minLines[action]) {
+        minLines[action] = lines;
+    }
+    if (lines > maxLines[action]) {
+        maxLines[action] = lines;
+    }
+    totalLines[action] += lines;
+    samples[action]++;
+}
+
+static void _clearLatency() {
+    for (int a = 0; a < ACTION_COUNT; a++) {
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            histogram[a][b] = 0;
+        }
+        samples[a] = 0;
+        totalLines[a] = 0;
+        minLines[a] = 0;
+        maxLines[a] = 0;
+    }
+    pendingCount = 0;
+}
@@ -0,0 +1,26 @@
+// Input latency measurement (make LATENCY=1). Each action that moves the
+// piece is timed from the button change behind it to when the change is
+// written to VRAM and then scanned out to the screen. Histograms per action
+// are written to the debug log when a game ends. In normal builds the LATENCY
+// macros compile to nothing.
+
+// Histogram buckets are a quarter of a frame wide, and the last one also
+// counts everything slower
+#define LATENCY_BUCKET_LINES 57
+#define LATENCY_BUCKETS 24
+// The most actions that can wait for the same draw
+#define LATENCY_PENDING 8
+
+#ifdef LATENCY
+#define LATENCY_ACTION(action, row) noteLatencyAction(action, row)
+#define LATENCY_DRAWN() noteLatencyDrawn()
+#define LATENCY_DUMP() dumpLatency()
+#else
+#define LATENCY_ACTION(action, row)
+#define LATENCY_DRAWN()
+#define LATENCY_DUMP()
+#endif
+
+void noteLatencyAction(enum ACTION action, int row);
+void noteLatencyDrawn();
+void dumpLatency();
@@ -1,5 +1,3 @@
-#include <stdlib.h>
-
 #include "gbalib.h"
 #include "main.h"
 #include "gameboard.h"
@@ -9,11 +7,30 @@
 #include "background/BACKGROUND.h"
 #include "background/ENDGAME.h"
 #include "music.h"
+#include "clock.h"
+#include "scheduler.h"
+#include "input.h"
+#include "irq.h"
+#include "sound.h"
+#include "profile.h"
+#include "trace.h"
+#include "sampler.h"
+#include "latency.h"
+#include "debug.h"
+#include "drawqueue.h"
+#include "pentomino.h"
+#include "render.h"
+#include "benchmark.h"
+#include "save.h"
+#include "suspend.h"
 
-#define EASY_GRAVITY 90
-#define HARD_GRAVITY 45
-#define GRAVITY_STEP 2
-#define MIN_GRAVITY  5
+#define EASY_GRAVITY (GRAVITY_ONE / 90) // one row every 90 ticks
+#define HARD_GRAVITY (GRAVITY_ONE / 45)
+#define GRAVITY_STEP 2 // ticks taken off the row delay per line cleared
+#define MIN_GRAVITY  5 // row delay at which the slow curve ends
+#define FAST_GRAVITY_STEP (GRAVITY_ONE / 16) // cells per tick added per line
+#define LINES_PER_LEVEL 10 // lines cleared before the music picks up
+#define PAUSE_DIM 10 // sixteenths of the way to black the paused screen is
 
 enum GAMESTATE {
     STATE_MENU_INIT,
@@ -27,113 +44,280 @@ enum GAMESTATE {
 // the current state of the game
 static enum GAMESTATE globalState;
 
-// used to set the game's seed
+static void setState(enum GAMESTATE state);
+static void pauseGame();
+
+// used to set the game's seed (counts game ticks)
 static int vblankCount;
 
-// used to control pentomino gravity
-static int advancementTimer; // how many vblank's ago the last drop was
-static int gravityDelay; // how many vblanks until a tile is forced to drop
+// lines cleared this game
+static int linesCleared;
+
+// Set when the next game is a suspended one being resumed rather than a new
+// one
+static bool resuming;
 
-// used to keep track of which buttons are being held (and therefore ignored)
-static unsigned int previousButtonState;
+// Set when Start is pressed during a game, so that it's paused once the
+// frame's ticks stop
+static bool pausing;
 
 int main() {
+    // Speed up ROM access before anything else runs from it
+    REG_WAITCNT = WAITCNT_FAST;
+    
     // Enter Display mode 3
     REG_DISPCNT = MODE_3 | BG2_EN;
     
     // Set initial game conditions
-    advancementTimer = 0;
-    gravityDelay = 90;
-    previousButtonState = 0xFFFF;
-    globalState = STATE_MENU_INIT;
+    setState(STATE_MENU_INIT);
+    
+    // Set up interrupts before anything registers for one
+    initInterrupts();
+    initDebugLog();
+    initTileSprites();
+    TRACE_INIT();
+    
+    // Load the high scores and the settings of the last game played
+    initSave((SETTINGS) {EASY_GRAVITY, FALSE});
     
     // Start playing music
     initMusic();
     
+    // Start the hardware clock that paces the game logic
+    initClock();
+    BENCHMARK_RUN();
+    initScheduler();
+    initInput();
+    SAMPLER_INIT();
+    
     // Begin game loop
     while (TRUE) {
-        onUpdate();
-        
-        // Keep track of which buttons are being held
-        previousButtonState = BUTTONS;
+        // Run one game tick for every frame's worth of time that has passed.
+        // If the last draw overran the frame, this runs the missed ticks
+        // back to back so the game keeps its speed, and the draws for those
+        // frames are coalesced into the next one.
+        int ticks = getDueTicks();
+        PROFILE_BEGIN(PROFILE_UPDATE);
+        for (int i = 0; i < ticks && !pausing; i++) {
+            onUpdate();
+            vblankCount++;
+        }
+        PROFILE_END(PROFILE_UPDATE);
+        finishUpdate(ticks);
         
-        vblankCount++;
         waitForVblank();
         
-        onDraw();
+        // Nothing has changed if no ticks ran, so there's nothing to draw
+        if (ticks) {
+            PROFILE_BEGIN(PROFILE_DRAW);
+            onDraw();
+            PROFILE_END(PROFILE_DRAW);
+        }
+        
+        updateMusic();
+        updateSave();
+        
+        // Racing the raster is meant to run on past VBlank, so it's left out
+        // of the draw time the profiler checks for overruns. It goes last, and
+        // stops early enough for what follows to be done by the next VBlank.
+        runRaces();
+        PROFILE_FRAME();
+        TRACE_DRAIN();
+        
+        // Pausing waits until the frame that asked for it has been drawn.
+        // Any ticks that were still due are thrown away, so the game picks up
+        // on resume exactly where it was on screen.
+        if (pausing) {
+            pauseGame();
+            pausing = FALSE;
+        }
     }
 }
 
-void startGame(int startingGravity) {
+static void setState(enum GAMESTATE state) {
+    globalState = state;
+    TRACE_EVENT(TRACE_STATE, state);
+}
+
+// Starts a game, and remembers how it was started so START can play the same
+// way next time
+void startGame(int startingGravity, bool useBag) {
+    setSettings((SETTINGS) {startingGravity, useBag});
+    
     // Set the game's seed
-    srand(vblankCount);
-    globalState = STATE_PLAY_INIT;
+    seedPieces(vblankCount, useBag);
+    setState(STATE_PLAY_INIT);
+    clearActions();
+    resuming = FALSE;
+    linesCleared = 0;
+    setMusicLevel(0);
     
     // set the gravity
-    gravityDelay = startingGravity;
+    setGravity(startingGravity);
+    resetGravity();
+}
+
+// Picks up a suspended game where it was left off. It's loaded once the
+// background has been drawn, in the same frame.
+static void resumeSuspendedGame() {
+    setState(STATE_PLAY_INIT);
+    clearActions();
+    resuming = TRUE;
+}
+
+// Start pauses the game, between frames. The screen is dimmed, the music is
+// stopped, and the CPU sleeps until Start is pressed again, with nothing else
+// allowed to wake it. No time passes for the game while it's paused, so the
+// ticks it slept through aren't caught up on, and the buttons start over.
+static void pauseGame() {
+    REG_BLDCNT = BLD_BG2 | BLD_BD | BLD_DARKEN;
+    REG_BLDY = PAUSE_DIM;
+    pauseMusic();
+    
+    // Start is still down from pausing, and would wake the CPU right back up
+    while (KEY_DOWN_NOW(BUTTON_START)) {
+        waitForVblank();
+    }
+    sleepUntilKeys(BUTTON_START);
+    
+    REG_BLDCNT = 0;
+    resumeMusic();
+    resetInput();
+    resyncScheduler();
 }
 
 void onUpdate() {
-    // Restart the game if select is pressed
-    if (keyPressStart(BUTTON_SELECT)
-            || (globalState == STATE_END && keyPressStart(BUTTON_A))) {
-        globalState = STATE_MENU_INIT;
+    updateInput();
+    
+    // A game that's over goes to the end screen before anything else, so it
+    // can't be suspended or paused
+    if (globalState == STATE_PLAY && isGameOver()) {
+        playSoundEffect(SOUND_GAME_OVER);
+        setState(STATE_END_INIT);
+        addHighScore(getScore());
+        SAMPLER_DUMP();
+        LATENCY_DUMP();
+        return;
+    }
+    
+    // Select suspends a game in progress and goes back to the menu. Anywhere
+    // else, it just goes back to the menu.
+    if (keyPressStart(BUTTON_SELECT)) {
+        if (globalState == STATE_PLAY) {
+            suspendGame();
+        }
+        setState(STATE_MENU_INIT);
+    } else if (globalState == STATE_END && keyPressStart(BUTTON_A)) {
+        setState(STATE_MENU_INIT);
     }
     
     if (globalState == STATE_MENU_INIT) {
         resetBoard();
         resetPlacer();
     } else if (globalState == STATE_MENU && keyPressStart(BUTTON_ANY)) {
+        // Holding L deals the pieces from a bag
         if (keyPressStart(BUTTON_A)) {
-            startGame(EASY_GRAVITY);
+            startGame(EASY_GRAVITY, keyHeld(BUTTON_L));
         } else if (keyPressStart(BUTTON_B)) {
-            startGame(HARD_GRAVITY);
+            startGame(HARD_GRAVITY, keyHeld(BUTTON_L));
+        } else if (keyPressStart(BUTTON_R)) {
+            startGame(MAX_GRAVITY, keyHeld(BUTTON_L));
+        } else if (keyPressStart(BUTTON_START)) {
+            // Start picks up a suspended game, or else starts one the way
+            // the last one was
+            if (hasSuspendedGame()) {
+                resumeSuspendedGame();
+            } else {
+                SETTINGS settings = getSettings();
+                startGame(settings.startingGravity, settings.bagPieces);
+            }
         }
     } else if (globalState == STATE_PLAY_INIT) {
         
     } else if (globalState == STATE_PLAY) {
-        if (isGameOver()) {
-            globalState = STATE_END_INIT;
+        if (keyPressStart(BUTTON_START)) {
+            pausing = TRUE;
         } else {
             onGameTick();
         }
     }
 }
 
-// Returns true if a specified button was pressed since the last game tick
-// (and only if it was pressed since the last game tick)
-bool keyPressStart(int button) {
-    return KEY_DOWN_NOW(button) != (~(previousButtonState) & button)
-            && KEY_DOWN_NOW(button);
-}
-
 // When the game is active, each the period before each vblank draw cycle
-// triggers a game tick, in which inputs and events are processed
+// triggers a game tick, in which inputs and events are processed. Every action
+// the player queued up is handled in the order it happened.
 void onGameTick() {
-    if (keyPressStart(BUTTON_LEFT) || keyPressStart(BUTTON_RIGHT)) {
-        handleTileMove();
-    } else if (keyPressStart(BUTTON_A)) {
-        handleTileDrop();
-    } else if (keyPressStart(BUTTON_L) || keyPressStart(BUTTON_R)) {
-        handleTileRotate();
-    } else if (keyPressStart(BUTTON_DOWN)) {
-        advancementTimer = 0;
-        handleTileMove();
-    } else if (!isClearingRow()) {
-        advancementTimer++;
-        if (advancementTimer >= gravityDelay) {
-            advancementTimer = 0;
-            applyGravity();
+    // There's no piece to move while cleared rows flash, so anything pressed
+    // then is dropped rather than saved up for the next piece
+    if (!isPlacing()) {
+        clearActions();
+    }
+    
+    enum ACTION action;
+    while (isPlacing() && (action = popAction()) != ACTION_NONE) {
+        if (action == ACTION_MOVE_LEFT) {
+            handleTileMove(-1);
+        } else if (action == ACTION_MOVE_RIGHT) {
+            handleTileMove(1);
+        } else if (action == ACTION_ROTATE_CW) {
+            handleTileRotate(TRUE);
+        } else if (action == ACTION_ROTATE_CCW) {
+            handleTileRotate(FALSE);
+        } else if (action == ACTION_SOFT_DROP) {
+            resetGravity();
+            handleSoftDrop();
+        } else if (action == ACTION_HARD_DROP) {
+            handleTileDrop();
+            // The piece is gone now, so leave anything else for the next one
+            break;
         }
     }
-    checkRowClear();
+    
+    if (isPlacing()) {
+        applyGravity();
+    }
+    // The next piece comes in once the rows the last one cleared are done
+    if (updateRowClear()) {
+        popPiece();
+    }
+    
+    // Describe what this tick changed for the next draw
+    renderPlacingTile();
+    updateDash();
 }
 
 // Called when a single line is cleared to make the game even harder >;)
+// At first each row falls GRAVITY_STEP ticks sooner than the last, like the
+// original frame countdown did. Once rows fall every MIN_GRAVITY ticks, the
+// gravity keeps climbing a fraction of a cell per tick at a time, up to 20G.
+// The music speeds up every LINES_PER_LEVEL lines.
 void speedUp() {
-    if (gravityDelay > MIN_GRAVITY) {
-        gravityDelay -= GRAVITY_STEP;
+    linesCleared++;
+    setMusicLevel(linesCleared / LINES_PER_LEVEL);
+    
+    int gravity = getGravity();
+    if (gravity < GRAVITY_ONE / MIN_GRAVITY) {
+        int delay = GRAVITY_ONE / gravity - GRAVITY_STEP;
+        gravity = GRAVITY_ONE / delay;
+    } else {
+        gravity += FAST_GRAVITY_STEP;
     }
+    
+    if (gravity > MAX_GRAVITY) {
+        gravity = MAX_GRAVITY;
+    }
+    setGravity(gravity);
+}
+
+int getLinesCleared() {
+    return linesCleared;
+}
+
+// Puts back the lines cleared in a resumed game, and the music's speed with
+// them
+void setLinesCleared(int lines) {
+    linesCleared = lines;
+    setMusicLevel(linesCleared / LINES_PER_LEVEL);
 }
 
 // Dispatch draw calls. This function is called during VBlank
@@ -141,26 +325,43 @@ void onDraw() {
     if (globalState == STATE_MENU_INIT) {
         // Draw splash screen and move to idle menu state
         drawImage3(0, 0, SPLASH_WIDTH, SPLASH_HEIGHT, SPLASH_data);
-        globalState = STATE_MENU;
+        setState(STATE_MENU);
     } else if (globalState == STATE_PLAY_INIT) {
         // Draw game background, initialize the game, and move to active state
         drawImage3(0, 0, BACKGROUND_WIDTH, BACKGROUND_HEIGHT, BACKGROUND_data);
-        setScore(0);
-        generateNext();
-        popPiece();
-        globalState = STATE_PLAY;
+        clearDraws();
+        clearRenderCommands();
+        if (resuming && !resumeGame()) {
+            // The suspended game is gone, so start a new one the way Start
+            // would have without it
+            SETTINGS settings = getSettings();
+            startGame(settings.startingGravity, settings.bagPieces);
+        }
+        if (!resuming) {
+            setScore(0);
+            fillNextQueue();
+            popPiece();
+        }
+        setState(STATE_PLAY);
     } else if (globalState == STATE_END_INIT) {
         // Draw the game over screen and move to the idle end state
         drawImage3(0, 0, ENDGAME_WIDTH, ENDGAME_HEIGHT, ENDGAME_data);
         // Draw the final score
         drawScore(122, 68);
-        globalState = STATE_END;
+        // and the best one so far under it
+        drawHighScore(122, 80);
+        setState(STATE_END);
     } else if (globalState == STATE_PLAY) {
-        // Delegate game draw calls
+        // Play back what the game ticks changed as one batch. The falling
+        // piece is what the player is watching, so the batch always goes, and
+        // it goes first so that whatever it asks to have drawn is queued up
+        // with everything else. Then draw what fits in this VBlank.
+        runRenderCommands();
         drawRowClear();
         drawDash();
-        drawPlacingTile();
     }
     // Menus have static images, so if we're on a menu in its idle state, we
-    // don't have to do anything here.
+    // don't have to do anything here. Whatever is queued to draw, like the
+    // profiler's HUD, is drawn in any state.
+    runDraws();
 }
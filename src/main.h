@@ -5,4 +5,5 @@ void onGameTick();
 
 // public prototypes for main.c
 void speedUp();
-bool keyPressStart(int key);
+int getLinesCleared();
+void setLinesCleared(int lines);
@@ -0,0 +1,150 @@
+#include "gbalib.h"
+#include "music.h"
+#include "clock.h"
+#include "mixer.h"
+
+typedef struct {
+    const signed char *data;
+    int length;
+    int position;
+} VOICE;
+
+// Two halves of mixed sound effects, played by DMA 2 into FIFO B in lockstep
+// with the music buffer in music.c (see there for how the guard works)
+static signed char mixBuffer[2 * AUDIO_HALF_SAMPLES + AUDIO_BUFFER_GUARD]
+        __attribute__((aligned(4)));
+// Voices are summed here at full precision before being clipped to 8 bits
+static short mixAccumulator[AUDIO_FRAME_SAMPLES];
+
+static VOICE voices[MIXER_VOICES];
+
+// Timing of the mixer itself, in CPU cycles
+static unsigned int mixCycles;
+static unsigned int peakMixCycles;
+
+static void _mixVoice(VOICE *voice);
+
+// Silences every voice and the mix buffer
+void initMixer() {
+    for (int i = 0; i < MIXER_VOICES; i++) {
+        voices[i].data = 0;
+    }
+    for (int i = 0; i < 2 * AUDIO_HALF_SAMPLES + AUDIO_BUFFER_GUARD; i++) {
+        mixBuffer[i] = 0;
+    }
+    mixCycles = 0;
+    peakMixCycles = 0;
+}
+
+// Starts playing a sample on a free voice, or steals the voice that's
+// furthest along if they're all busy. Samples must be signed 8-bit at the
+// music's sample rate. Starting a sample that was already started since the
+// last mix does nothing, so it doesn't play twice as loud.
+void playSample(const signed char *data, int length) {
+    for (int i = 0; i < MIXER_VOICES; i++) {
+        if (voices[i].data == data && voices[i].position == 0) {
+            return;
+        }
+    }
+    
+    int chosen = 0;
+    for (int i = 0; i < MIXER_VOICES; i++) {
+        if (!voices[i].data) {
+            chosen = i;
+            break;
+        }
+        if (voices[i].position > voices[chosen].position) {
+            chosen = i;
+        }
+    }
+    
+    // The mixer runs from an interrupt, so don't let it see a half set voice
+    REG_IME &= ~IRQ_ENABLE;
+    voices[chosen].data = data;
+    voices[chosen].length = length;
+    voices[chosen].position = 0;
+    REG_IME |= IRQ_ENABLE;
+}
+
+// Points DMA 2 at the start of a half of the mix buffer and throws out
+// whatever it read ahead. Called by music.c whenever it restarts the music DMA.
+void restartMixerDma(int half) {
+    REG_DMACNT(2) = 0;
+    REG_SNDDSCNT |= DSB_RST_FIFO;
+    REG_DMASRC(2) = (int) &mixBuffer[half * AUDIO_HALF_SAMPLES];
+    REG_DMADST(2) = (int) REG_FIFO_B;
+    REG_DMACNT(2) = DMA_ON | START_ON_FIFO_EMPTY | DMA_32 | DMA_REPEAT;
+}
+
+// Mixes the next frame of sound effects into one frame of the mix buffer.
+// Called by music.c for each frame of a half it refills, after that half
+// finished playing.
+IWRAM_CODE void mixSoundFrame(int frame) {
+    unsigned int start = getCycles();
+    
+    signed char *out = &mixBuffer[frame * AUDIO_FRAME_SAMPLES];
+    bool active = FALSE;
+    for (int i = 0; i < AUDIO_FRAME_SAMPLES; i++) {
+        mixAccumulator[i] = 0;
+    }
+    for (int v = 0; v < MIXER_VOICES; v++) {
+        if (voices[v].data) {
+            _mixVoice(&voices[v]);
+            active = TRUE;
+        }
+    }
+    
+    if (active) {
+        for (int i = 0; i < AUDIO_FRAME_SAMPLES; i++) {
+            int sample = mixAccumulator[i];
+            if (sample > 127) {
+                sample = 127;
+            } else if (sample < -128) {
+                sample = -128;
+            }
+            out[i] = sample;
+        }
+    } else {
+        for (int i = 0; i < AUDIO_FRAME_SAMPLES; i++) {
+            out[i] = 0;
+        }
+    }
+    
+    if (frame == 0) {
+        for (int i = 0; i < AUDIO_BUFFER_GUARD; i++) {
+            mixBuffer[2 * AUDIO_HALF_SAMPLES + i] = out[i];
+        }
+    }
+    
+    mixCycles = getCycles() - start;
+    if (mixCycles > peakMixCycles) {
+        peakMixCycles = mixCycles;
+    }
+}
+
+// The number of cycles the last frame took to mix
+unsigned int getMixerCycles() {
+    return mixCycles;
+}
+
+// The most cycles any frame has taken to mix
+unsigned int getMixerPeakCycles() {
+    return peakMixCycles;
+}
+
+// Adds a frame's worth of a voice into the accumulator, and frees the voice
+// once its sample runs out
+IWRAM_CODE static void _mixVoice(VOICE *voice) {
+    int remaining = voice->length - voice->position;
+    int count = remaining < AUDIO_FRAME_SAMPLES ? remaining : AUDIO_FRAME_SAMPLES;
+    const signed char *data = voice->data + voice->position;
+    
+    for (int i = 0; i < count; i++) {
+        mixAccumulator[i] += data[i];
+    }
+    
+    voice->position += count;
+    if (voice->position >= voice->length) {
+        voice->data = 0;
+    }
+}
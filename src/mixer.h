@@ -0,0 +1,10 @@
+// The most sound effects that can play at once. Starting another one cuts off
+// whichever has been playing the longest.
+#define MIXER_VOICES 4
+
+void initMixer();
+void playSample(const signed char *data, int length);
+void restartMixerDma(int half);
+void mixSoundFrame(int frame);
+unsigned int getMixerCycles();
+unsigned int getMixerPeakCycles();
@@ -1,37 +1,283 @@
+#include "gbalib.h"
 #include "music.h"
-#include "korobeiniki.h"
+#include "irq.h"
+#include "psg.h"
+#include "profile.h"
+#include "trace.h"
 
-#define SONGLEN KOROBEINIKILEN
-#define SONGFREQ KOROBEINIKIFREQ
-#define SONGDATA korobeiniki
+#ifdef MUSIC_MAXMOD
+
+#include <maxmod.h>
+#include "soundbank.h"
+
+// Built from the music directory by mmutil and linked in by bin2o
+extern const unsigned char soundbank_bin[];
 
-int vblankcnt;
+// Order of the first pattern of part B in the module (see tools/mkmod.py)
+#define PART_B_ORDER 4
+// Tempo scale where 0x400 is the module's own tempo, raised every level up
+// to the fastest maxmod allows
+#define BASE_TEMPO  0x400
+#define LEVEL_TEMPO 0x40
+#define MAX_TEMPO   0x800
 
-// This is all from the advanced lecture slides
+static int musicLevel;
+
+// Memory for maxmod. mmInitDefault would malloc this, but there's no C library
+// to malloc from. The mixing buffer has to be in IWRAM.
+static unsigned char moduleChannels[MUSIC_CHANNELS * MM_SIZEOF_MODCH];
+static unsigned char activeChannels[MUSIC_CHANNELS * MM_SIZEOF_ACTCH];
+static unsigned char mixingChannels[MUSIC_CHANNELS * MM_SIZEOF_MIXCH];
+static unsigned char mixingMemory[MM_MIXLEN_16KHZ] __attribute__((aligned(4)));
+static unsigned char waveMemory[MM_MIXLEN_16KHZ] __attribute__((aligned(4))) EWRAM_BSS;
+
+// mmVBlank has to run as soon as possible after VBlank starts, since it
+// restarts the DMA that feeds the mixed audio to the FIFO
 void vblankHandler() {
+    mmVBlank();
+    updatePsg();
+}
+
+void initMusic() {
     REG_IME &= ~IRQ_ENABLE;
-    if(!vblankcnt--) {
-        REG_TMD(0) = 0;
-        REG_TMCNT(0) = 0;
-        initMusic(); // loop
-    }
-    REG_IF = REG_IF;
+    // maxmod takes timer 0 and DMA 1 for itself, and leaves the tone and
+    // noise channels to us
+    mm_gba_system system = {
+        .mixing_mode = MM_MIX_16KHZ,
+        .mod_channel_count = MUSIC_CHANNELS,
+        .mix_channel_count = MUSIC_CHANNELS,
+        .module_channels = (mm_addr) moduleChannels,
+        .active_channels = (mm_addr) activeChannels,
+        .mixing_channels = (mm_addr) mixingChannels,
+        .mixing_memory = (mm_addr) mixingMemory,
+        .wave_memory = (mm_addr) waveMemory,
+        .soundbank = (mm_addr) soundbank_bin
+    };
+    mmInit(&system);
+    initPsg();
+    
+    musicLevel = 0;
+    mmStart(MOD_KOROBEINIKI, MM_PLAY_LOOP);
+    
+    REG_DISPSTAT |= INT_VBLANK_ENABLE;
+    setInterruptHandler(IRQ_VBLANK, vblankHandler);
+    enableInterrupt(IRQ_VBLANK);
     REG_IME |= IRQ_ENABLE;
 }
 
+// Mixes the next frame of the module. This is the heavy part of playback, so
+// it's left to the main loop instead of the VBlank interrupt.
+void updateMusic() {
+    PROFILE_BEGIN(PROFILE_MUSIC);
+    mmFrame();
+    PROFILE_END(PROFILE_MUSIC);
+}
+
+// Each level plays the module a bit faster. Levels alternate between the
+// two parts of the song, so the music changes as the game speeds up without
+// needing another module.
+void setMusicLevel(int level) {
+    if (level == musicLevel) {
+        return;
+    }
+    
+    int tempo = BASE_TEMPO + level * LEVEL_TEMPO;
+    if (tempo > MAX_TEMPO) {
+        tempo = MAX_TEMPO;
+    }
+    mmSetModuleTempo(tempo);
+    mmPosition(level % 2 ? PART_B_ORDER : 0);
+    musicLevel = level;
+}
+
+// maxmod keeps its own buffers and doesn't say when it falls behind
+int getMusicUnderruns() {
+    return 0;
+}
+
+#else
+
+#include "adpcm.h"
+#ifdef PCM_SOUND_EFFECTS
+#include "mixer.h"
+#endif
+#include "korobeiniki.h"
+
+#define SONGLENGTH KOROBEINIKI_LENGTH
+#define SONGBLOCKSAMPLES KOROBEINIKI_BLOCK_SAMPLES
+#define SONGDATA korobeiniki
+
+// Two halves of decoded audio, played back to back by DMA 1 from IWRAM so it
+// doesn't compete with drawing for the ROM bus. DMA runs off the end of the
+// first half into the second on its own, and is pointed back at the first
+// when the second has been played. Since DMA reads ahead of playback, the
+// start of the first half is mirrored after the second, so anything DMA reads
+// before it's pointed back is still the right audio.
+static signed char audioBuffer[2 * AUDIO_HALF_SAMPLES + AUDIO_BUFFER_GUARD]
+        __attribute__((aligned(4)));
+// The half of the buffer that DMA is playing right now
+static int playingHalf;
+// Set by the swap interrupt for a half that has been played, until the main
+// loop has refilled it
+static volatile bool halfPlayed[2];
+// The number of times a half was due to play before it had been refilled
+static int underruns;
+// The next sample of the song to decode, and the decoder positioned there
+static int songSample;
+static ADPCM_DECODER decoder;
+
+static void _refillHalf(int half);
+
+// Called when the swap timer has counted AUDIO_HALF_SAMPLES samples out of the
+// FIFO, which is exactly when DMA finishes playing a half of the buffer. This
+// only points DMA at the next half and marks the one that finished for the
+// main loop to refill, so it's done well before the next sample is due.
+IWRAM_CODE void audioSwapHandler() {
+    if (playingHalf == 1) {
+        // Point DMA back at the first half. Resetting the FIFO throws out
+        // what DMA read ahead, so playback picks up exactly where it was.
+        REG_DMACNT(1) = 0;
+        REG_SNDDSCNT |= DSA_RST_FIFO;
+        REG_DMASRC(1) = (int) audioBuffer;
+        REG_DMACNT(1) = DMA_ON | START_ON_FIFO_EMPTY | DMA_32 | DMA_REPEAT;
+#ifdef PCM_SOUND_EFFECTS
+        restartMixerDma(0);
+#endif
+    }
+    
+    halfPlayed[playingHalf] = TRUE;
+    playingHalf = !playingHalf;
+    if (halfPlayed[playingHalf]) {
+        underruns++;
+    }
+}
+
 void initMusic() {
     REG_IME &= ~IRQ_ENABLE;
     REG_SNDSTAT = MASTER_SND_EN;
     REG_DMACNT(1) = 0;
-    REG_SNDDSCNT = DMG_VOL_100 | DSA_EN_L | DSA_EN_R | DSA_RST_FIFO;
-    vblankcnt = (int)(59.77 * SONGLEN / SONGFREQ);
-    REG_TMD(0) = -((1 << 24) / SONGFREQ);
-    REG_TMCNT(0) = TM_ENABLE | TM_FREQ_1;
-    REG_DMASRC(1) = (int) SONGDATA;
+    REG_TMCNT(AUDIO_SAMPLE_TIMER) = 0;
+    REG_TMCNT(AUDIO_SWAP_TIMER) = 0;
+    REG_SNDDSCNT = DMG_VOL_100 | DSA_EN_L | DSA_EN_R | DSA_RST_FIFO
+            | DSB_VOL_100 | DSB_EN_L | DSB_EN_R | DSB_RST_FIFO;
+#ifdef PCM_SOUND_EFFECTS
+    initMixer();
+#endif
+    initPsg();
+    
+    // Fill both halves ahead of time
+    songSample = 0;
+    underruns = 0;
+    startAdpcmBlock(&decoder, SONGDATA);
+    _refillHalf(0);
+    _refillHalf(1);
+    
+    // The swap timer counts the sample timer's overflows, one per sample
+    // played, and interrupts once a whole half has been played
+    REG_TMD(AUDIO_SAMPLE_TIMER) = -AUDIO_CYCLES_PER_SAMPLE;
+    REG_TMD(AUDIO_SWAP_TIMER) = -AUDIO_HALF_SAMPLES;
+    REG_TMCNT(AUDIO_SWAP_TIMER) = TM_ENABLE | TM_IRQ | TM_CASCADE;
+    setInterruptHandler(AUDIO_SWAP_IRQ, audioSwapHandler);
+    enableInterrupt(AUDIO_SWAP_IRQ);
+    
+    REG_DMASRC(1) = (int) audioBuffer;
     REG_DMADST(1) = (int) REG_FIFO_A;
     REG_DMACNT(1) = DMA_ON | START_ON_FIFO_EMPTY | DMA_32 | DMA_REPEAT;
-    REG_IE |= IRQ_VBLANK;
-    REG_DISPSTAT |= INT_VBLANK_ENABLE;
-    REG_ISR_MAIN = vblankHandler;
+#ifdef PCM_SOUND_EFFECTS
+    restartMixerDma(0);
+#endif
+    playingHalf = 0;
+    REG_TMCNT(AUDIO_SAMPLE_TIMER) = TM_ENABLE | TM_FREQ_1;
     REG_IME |= IRQ_ENABLE;
 }
+
+// Refills whichever halves have been played since the last frame, along with
+// the sound effects that go with them. The tone and noise channel sequencer
+// steps along here too, since this runs once a frame.
+void updateMusic() {
+    PROFILE_BEGIN(PROFILE_MUSIC);
+    for (int half = 0; half < 2; half++) {
+        if (halfPlayed[half]) {
+            _refillHalf(half);
+            halfPlayed[half] = FALSE;
+        }
+    }
+    updatePsg();
+    PROFILE_END(PROFILE_MUSIC);
+}
+
+void setMusicLevel(int level) {
+    (void) level;
+}
+
+// The number of times the music played a half of its buffer that the main
+// loop hadn't got around to refilling
+int getMusicUnderruns() {
+    return underruns;
+}
+
+// Decodes the next part of the song into one half of the buffer, and mixes
+// the sound effects for it one frame at a time. The song loops on its exact
+// last sample rather than at the end of its last block, so a half can end one
+// pass through the song and start the next.
+IWRAM_CODE static void _refillHalf(int half) {
+    signed char *out = &audioBuffer[half * AUDIO_HALF_SAMPLES];
+    int decoded = 0;
+    
+    while (decoded < AUDIO_HALF_SAMPLES) {
+        int count = AUDIO_HALF_SAMPLES - decoded;
+        if (count > SONGBLOCKSAMPLES - decoder.position) {
+            count = SONGBLOCKSAMPLES - decoder.position;
+        }
+        if (count > SONGLENGTH - songSample) {
+            count = SONGLENGTH - songSample;
+        }
+        
+        decodeAdpcm(&decoder, out + decoded, count);
+        decoded += count;
+        songSample += count;
+        
+        if (songSample >= SONGLENGTH) {
+            TRACE_EVENT(TRACE_AUDIO_LOOP, 0);
+            songSample = 0;
+            startAdpcmBlock(&decoder, SONGDATA);
+        } else if (decoder.position >= SONGBLOCKSAMPLES) {
+            startAdpcmBlock(&decoder, &SONGDATA[(songSample / SONGBLOCKSAMPLES)
+                    * ADPCM_BLOCK_SIZE(SONGBLOCKSAMPLES)]);
+        }
+    }
+    
+    if (half == 0) {
+        for (int i = 0; i < AUDIO_BUFFER_GUARD; i++) {
+            audioBuffer[2 * AUDIO_HALF_SAMPLES + i] = out[i];
+        }
+    }
+    
+#ifdef PCM_SOUND_EFFECTS
+    for (int frame = 0; frame < AUDIO_BUFFER_FRAMES; frame++) {
+        mixSoundFrame(half * AUDIO_BUFFER_FRAMES + frame);
+    }
+#endif
+}
+
+#endif
+
+// The tone and noise channels' volume and enables, kept while paused
+static unsigned short psgControl;
+
+// Silences everything for a pause. Both kinds of music and the sound effects
+// are clocked by the sample timer, so stopping it stops the FIFOs draining,
+// the DMA feeding them, and the swap timer counting. The tone and noise
+// channels are muted too, in case they were in the middle of a note.
+void pauseMusic() {
+    REG_TMCNT(AUDIO_SAMPLE_TIMER) &= ~TM_ENABLE;
+    psgControl = REG_SNDDMGCNT;
+    REG_SNDDMGCNT = 0;
+}
+
+// Picks the music back up from exactly where it was paused
+void resumeMusic() {
+    REG_SNDDMGCNT = psgControl;
+    REG_TMCNT(AUDIO_SAMPLE_TIMER) |= TM_ENABLE;
+}
+
@@ -1,30 +1,3 @@
-// Interrupts
-#define REG_IE  *(volatile unsigned short*) 0x4000200
-#define REG_IF  *(volatile unsigned short*) 0x4000202
-#define REG_IME *(volatile unsigned short*) 0x4000208
-#define IRQ_ENABLE    1
-#define IRQ_VBLANK    (1 << 0)
-#define IRQ_HBLANK    (1 << 1)
-#define IRQ_VCOUNT    (1 << 2)
-#define IRQ_TIMER(n)  (1 << (3 + (n))) /* 0, 1, 2 or 3 */
-#define IRQ_COM       (1 << 7)
-#define IRQ_DMA(n)    (1 << (8 + (n)))
-#define IRQ_KEYPAD    (1 << 12)
-#define IRQ_CARTRIDGE (1 << 13)
-typedef void (*irqptr)(void);
-#define REG_ISR_MAIN *(volatile irqptr*) 0x3007FFC
-
-// Timers
-#define REG_TMD(n)   *(volatile unsigned short*)(0x4000100 + ((n) << 2))
-#define REG_TMCNT(n) *(volatile unsigned short*)(0x4000102 + ((n) << 2))
-#define TM_FREQ_1    0
-#define TM_FREQ_64   1
-#define TM_FREQ_256  2
-#define TM_FREQ_1024 3
-#define TM_CASCADE   (1 << 2)
-#define TM_IRQ       (1 << 6)
-#define TM_ENABLE    (1 << 7)
-
 // Legacy sound
 #define REG_SNDDMGCNT *(volatile unsigned short*) 0x4000080
 #define REG_SNDDSCNT  *(volatile unsigned short*) 0x4000082
@@ -65,11 +38,42 @@ typedef void (*irqptr)(void);
 #define DMA_32              (1 << 26)
 #define START_ON_FIFO_EMPTY (3 << 28)
 #define DMA_ON              (1 << 31)
-#define REG_DISPSTAT        *(volatile unsigned short*)0x4000004
-#define INT_VBLANK_ENABLE   (1 << 3)
 
 // Things that weren't in the powerpoint
 #define REG_FIFO_A             0x40000A0
+#define REG_FIFO_B             0x40000A4
+
+// Audio is played at a rate that divides evenly into a frame, so exactly
+// AUDIO_FRAME_SAMPLES samples are played per frame of video (about 21024 Hz)
+#define AUDIO_CYCLES_PER_SAMPLE 798
+#define AUDIO_FRAME_SAMPLES     352
+
+// The streamed song is double buffered in halves of this many frames. A half
+// only has to be refilled by the time the other one has been played, so the
+// main loop can fall a frame behind without the music skipping.
+#define AUDIO_BUFFER_FRAMES 2
+#define AUDIO_HALF_SAMPLES  (AUDIO_BUFFER_FRAMES * AUDIO_FRAME_SAMPLES)
+
+// Timer 0 overflows once per sample to clock the FIFOs. Timer 1 counts those
+// overflows and interrupts each time a half of the buffer has been played.
+#define AUDIO_SAMPLE_TIMER 0
+#define AUDIO_SWAP_TIMER   1
+#define AUDIO_SWAP_IRQ     IRQ_TIMER(AUDIO_SWAP_TIMER)
+
+// DMA reads up to 32 bytes ahead of playback. Audio buffers have room for that
+// after them, plus some slack so the swap can run a little late
+// without the FIFO being fed garbage.
+#define AUDIO_FIFO_LEAD  32
+#define AUDIO_SWAP_SLACK 32
+#define AUDIO_BUFFER_GUARD (AUDIO_FIFO_LEAD + AUDIO_SWAP_SLACK)
+
+// Number of module channels maxmod mixes when MUSIC_MAXMOD is defined
+#define MUSIC_CHANNELS 8
 
 void initMusic();
+void updateMusic();
+void setMusicLevel(int level);
+int getMusicUnderruns();
 
+void pauseMusic();
+void resumeMusic();
@@ -0,0 +1,57 @@
+#include <stddef.h>
+
+// The game is linked without the C library (see LDFLAGS in the Makefile).
+// These are the few pieces of it that the startup code and the compiler still
+// expect to find.
+
+typedef void (*initptr)(void);
+
+// Set up by the linker script around any constructors
+extern initptr __preinit_array_start[];
+extern initptr __preinit_array_end[];
+extern initptr __init_array_start[];
+extern initptr __init_array_end[];
+
+// The startup code tells newlib's allocator where the heap ends. Nothing
+// allocates, so it's only kept somewhere.
+char *fake_heap_end;
+
+// Built from crti.o and crtn.o, which are still linked in since only the
+// default libraries are left out
+void _init(void);
+
+void __libc_init_array();
+void *memcpy(void *dest, const void *src, size_t size);
+void *memset(void *dest, int value, size_t size);
+
+// Called by the startup code right before main. C code doesn't have
+// constructors, so there's normally nothing to run. This runs them in the
+// same order newlib does, with the .init section in between.
+void __libc_init_array() {
+    for (initptr *init = __preinit_array_start; init < __preinit_array_end; init++) {
+        (*init)();
+    }
+    _init();
+    for (initptr *init = __init_array_start; init < __init_array_end; init++) {
+        (*init)();
+    }
+}
+
+// GCC can turn struct copies and fills into calls to these. They're only ever
+// small, so there's no point in being clever.
+void *memcpy(void *dest, const void *src, size_t size) {
+    unsigned char *d = dest;
+    const unsigned char *s = src;
+    while (size--) {
+        *d++ = *s++;
+    }
+    return dest;
+}
+
+void *memset(void *dest, int value, size_t size) {
+    unsigned char *d = dest;
+    while (size--) {
+        *d++ = value;
+    }
+    return dest;
+}
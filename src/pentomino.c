@@ -2,7 +2,15 @@
 #include "gameboard.h"
 #include "pentomino.h"
 
+// Board offsets of each tile index from the center tile, following the grid
+// in pentomino.h (y increases towards the top of the board)
+static const POINT tileOffsets[12] = {
+    {0, 2}, {0, 1}, {-1, 1}, {2, 0}, {1, 0}, {1, 1},
+    {0, -2}, {0, -1}, {1, -1}, {-2, 0}, {-1, 0}, {-1, -1}
+};
+
 // Private prototypes
+int _columnDropDistance(int x, int y, int limit);
 bool _isTilePosValid(int x, int y);
 bool _isPentominoBottomValid(PENTOMINO pent);
 bool _isPentominoLeftValid(PENTOMINO pent);
@@ -10,14 +18,14 @@ bool _isPentominoRightValid(PENTOMINO pent);
 
 // Returns whether a pentomino has a tile at a specified tile index.
 // See pentomino.h for a list of indices and an explanation of why they're used
-bool hasTile(PENTOMINO pent, int tileIndex) {
+IWRAM_CODE bool hasTile(PENTOMINO pent, int tileIndex) {
     return (pent.data & (1 << tileIndex)) != 0;
 }
 
 // Private implementaion of drawing a pentomino
 // cX and cY represent the pixel coordinate of the top left corner of the center
 // tile in the pentomino
-void _drawPentomino(int cX, int cY, PENTOMINO pent) {
+IWRAM_CODE void _drawPentomino(int cX, int cY, PENTOMINO pent) {
     const unsigned short *tile = tileSpriteForType(pent.tile);
     
     // Draw the center tile since it's always there
@@ -91,6 +99,22 @@ void drawPentominoOnBoard(PENTOMINO pent) {
     _drawPentomino(cX, cY, pent);
 }
 
+// Draws just the tiles of a pentomino that are in one row of the board
+void drawPentominoRowOnBoard(PENTOMINO pent, int row) {
+    const unsigned short *tile = tileSpriteForType(pent.tile);
+    int cX = pent.pos.x * TILE_SIZE_PX + BOARD_OFFSET_X_PX;
+    int y = (BOARD_HEIGHT - 5 - row) * TILE_SIZE_PX;
+    
+    if (pent.pos.y == row) {
+        drawTileAtPixel(cX, y, tile);
+    }
+    for (int i = 0; i < 12; i++) {
+        if (hasTile(pent, i) && pent.pos.y + tileOffsets[i].y == row) {
+            drawTileAtPixel(cX + tileOffsets[i].x * TILE_SIZE_PX, y, tile);
+        }
+    }
+}
+
 // Draws a pentomino at a given pixel position. x and y here represent the
 // pixel coordinate of the entire pentomino
 void drawPentominoAtOffset(int x, int y, PENTOMINO pent) {
@@ -100,6 +124,30 @@ void drawPentominoAtOffset(int x, int y, PENTOMINO pent) {
     _drawPentomino(cX, cY, pent);
 }
 
+// Draws a pentomino scaled down to blocks of one color, tileSize pixels wide.
+// x and y are the pixel coordinate of the pentomino's 5x5 grid, like in
+// drawPentominoAtOffset.
+void drawPentominoMini(int x, int y, int tileSize, PENTOMINO pent) {
+    // The middle of a tile's sprite is the color of the piece
+    unsigned short color = tileSpriteForType(pent.tile)
+            [TILE_SIZE_PX * (TILE_SIZE_PX / 2) + TILE_SIZE_PX / 2];
+    int cX = x + (pent.pos.x + 2) * tileSize;
+    int cY = y + (pent.pos.y + 2) * tileSize;
+    
+    drawRect(cX, cY, tileSize, tileSize, color);
+    for (int i = 0; i < 12; i++) {
+        if (hasTile(pent, i)) {
+            // Tile offsets count up the board, but the screen counts down
+            drawRect(
+                cX + tileOffsets[i].x * tileSize,
+                cY - tileOffsets[i].y * tileSize,
+                tileSize,
+                tileSize,
+                color);
+        }
+    }
+}
+
 // Erases a pentomino from the board
 void erasePentomino(PENTOMINO pent) {
     pent.tile = NONE;
@@ -109,7 +157,7 @@ void erasePentomino(PENTOMINO pent) {
 // Checks if a pentomino is valid after being moved down
 // This is a slightly optimized computation of isPentominoValid that ignores
 // certain tile positions and prioritizes others
-bool _isPentominoBottomValid(PENTOMINO pent) {
+IWRAM_CODE bool _isPentominoBottomValid(PENTOMINO pent) {
 int cX = pent.pos.x;
     int cY = pent.pos.y;
     
@@ -178,7 +226,7 @@ int cX = pent.pos.x;
 // Checks if a pentomino is valid after being moved left
 // This is a slightly optimized computation of isPentominoValid that ignores
 // certain tile positions and prioritizes others
-bool _isPentominoLeftValid(PENTOMINO pent) {
+IWRAM_CODE bool _isPentominoLeftValid(PENTOMINO pent) {
     int cX = pent.pos.x;
     int cY = pent.pos.y;
     
@@ -250,7 +298,7 @@ bool _isPentominoLeftValid(PENTOMINO pent) {
 // Checks if a pentomino is valid after being moved right
 // This is a slightly optimized computation of isPentominoValid that ignores
 // certain tile positions and prioritizes others
-bool _isPentominoRightValid(PENTOMINO pent) {
+IWRAM_CODE bool _isPentominoRightValid(PENTOMINO pent) {
     int cX = pent.pos.x;
     int cY = pent.pos.y;
     
@@ -323,7 +371,7 @@ bool _isPentominoRightValid(PENTOMINO pent) {
 // Checks all tiles on a pentomino to make sure that it doens't go outside the
 // bounds of the board and that it doesn't collide with a tile already on the
 // board
-bool isPentominoValid(PENTOMINO pent) {
+IWRAM_CODE bool isPentominoValid(PENTOMINO pent) {
     int cX = pent.pos.x;
     int cY = pent.pos.y;
     
@@ -407,6 +455,32 @@ bool isPentominoValid(PENTOMINO pent) {
     return TRUE;
 }
 
+// Returns how many rows a pentomino can fall before it lands on a placed tile
+// or the bottom of the board. This looks down the board's columns directly,
+// so it costs the same whether the piece falls one row or twenty.
+IWRAM_CODE int dropDistance(PENTOMINO pent) {
+    int distance = _columnDropDistance(pent.pos.x, pent.pos.y, BOARD_HEIGHT);
+    for (int i = 0; i < 12 && distance > 0; i++) {
+        if (hasTile(pent, i)) {
+            distance = _columnDropDistance(
+                pent.pos.x + tileOffsets[i].x,
+                pent.pos.y + tileOffsets[i].y,
+                distance);
+        }
+    }
+    return distance;
+}
+
+// Counts the empty cells below a tile, up to limit
+IWRAM_CODE int _columnDropDistance(int x, int y, int limit) {
+    int distance = 0;
+    while (distance < limit && y - distance - 1 >= 0
+            && !hasTileAtPosition(x, y - distance - 1)) {
+        distance++;
+    }
+    return distance;
+}
+
 // Returns a copy of the pentomino after it has been rotated clockwise.
 // If the rotation isn't valid and would either go outside the bounds of the 
 // board, or would conflict with a placed tile, then the original pentomino
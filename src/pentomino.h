@@ -68,9 +68,12 @@ typedef struct {
 
 bool hasTile(PENTOMINO pent, int tileIndex);
 void drawPentominoOnBoard(PENTOMINO pent);
+void drawPentominoRowOnBoard(PENTOMINO pent, int row);
 void drawPentominoAtOffset(int x, int y, PENTOMINO pent);
+void drawPentominoMini(int x, int y, int tileSize, PENTOMINO pent);
 void erasePentomino(PENTOMINO pent);
 bool isPentominoValid(PENTOMINO pent);
+int dropDistance(PENTOMINO pent);
 PENTOMINO rotateCW(PENTOMINO pent);
 PENTOMINO rotateCCW(PENTOMINO pent);
 PENTOMINO moveDown(PENTOMINO pent);
@@ -3,29 +3,41 @@
 #include "gameboard.h"
 #include "pentomino.h"
 #include "dashboard.h"
-#include "main.h"
+#include "sound.h"
+#include "input.h"
+#include "trace.h"
+#include "latency.h"
+#include "render.h"
 
 #define D_SCORE_SOFT_DROP 1
 #define D_SCORE_HARD_DROP 2
+#define LOCK_DELAY 30 // ticks a piece can rest on the stack before it locks
+#define MAX_LOCK_RESETS 15 // moves that restart the lock delay, per piece
 
 static PENTOMINO current;
-static PENTOMINO prev;
+// The pentomino as it was last rendered. This is what needs to be erased when
+// the piece moves, not just the position from the previous action.
+static PENTOMINO rendered;
 
-// Used to force the tile to be commited after we draw it if the player
-// preformed a hard drop
-bool hardDrop = FALSE;
+// How fast pieces fall, in cells per tick (fixed point, see GRAVITY_ONE), and
+// the fraction of a cell the piece has fallen but not yet moved
+static int gravity;
+static int gravityAccumulator;
+// How long the piece has been resting on the stack, and how many more times
+// moving it can start that over
+static int lockTimer;
+static int lockResets;
 
 static void commit();
-
-// Used to avoid repeated calls when popping the random stack
-bool isGameStarted() {
-    return current.tile != NONE;
-}
+static void _resetLockDelay();
 
 // Called when the game ends to reset place.c's state
 void resetPlacer() {
     current = getPentomino(NONE);
-    prev = getPentomino(NONE);
+    rendered = getPentomino(NONE);
+    gravityAccumulator = 0;
+    lockTimer = 0;
+    lockResets = 0;
 }
 
 // Pops a piece from the dashboard and begins to place it on the board
@@ -33,74 +45,132 @@ void popPiece() {
     if (!isGameOver()) {
         current = getPentominoWithPos(
                 getNext(), BOARD_WIDTH / 2 - 1, BOARD_HEIGHT - 4);
-        prev = current;
-        prev.pos.y++;
-        generateNext();
+        TRACE_EVENT(TRACE_SPAWN, current.tile);
+        lockTimer = 0;
+        lockResets = MAX_LOCK_RESETS;
         if (!isPentominoValid(current)) {
             forceGameOver();
+        } else if (gravity >= MAX_GRAVITY) {
+            // At 20G the piece would fall the whole board in one tick anyway,
+            // so it spawns straight onto the stack
+            current.pos.y -= dropDistance(current);
         }
     }
 }
 
-// Called in the onUpdate phase in main to move the tile around based on user
-// button presses (only for the D-pad). This function doesn't handle gravity
-void handleTileMove() {
-    prev = current;
-    if (keyPressStart(BUTTON_LEFT)) {
+// Called in the onUpdate phase in main to move the tile left (-1) or right (1).
+// This function doesn't handle gravity
+void handleTileMove(int direction) {
+    int x = current.pos.x;
+    if (direction < 0) {
         current = moveLeft(current);
-    } else if (keyPressStart(BUTTON_RIGHT)) {
+    } else {
         current = moveRight(current);
-    } else if (keyPressStart(BUTTON_DOWN)) {
-        current = moveDown(current);
-        if (current.pos.y == prev.pos.y) {
-            commit();
-        } else {
-            incrementScore(D_SCORE_SOFT_DROP);
-        }
+    }
+    if (current.pos.x != x) {
+        _resetLockDelay();
+        LATENCY_ACTION(direction < 0 ? ACTION_MOVE_LEFT : ACTION_MOVE_RIGHT,
+                current.pos.y);
+    }
+}
+
+// Called in the onUpdate phase in main when the player soft drops the tile.
+// If the tile can't move down any further, it's committed to the board
+void handleSoftDrop() {
+    PENTOMINO prev = current;
+    current = moveDown(current);
+    LATENCY_ACTION(ACTION_SOFT_DROP, current.pos.y);
+    if (current.pos.y == prev.pos.y) {
+        playSoundEffect(SOUND_LOCK);
+        commit();
+    } else {
+        incrementScore(D_SCORE_SOFT_DROP);
     }
 }
 
 // Called in onUpdate when the 'A' button is pressed to preform a hard
-// drop of the tile
+// drop of the tile. The tile is committed right away.
 void handleTileDrop() {
-    int count = 0;
-    PENTOMINO moving = current;
-    while (moving.pos.y == current.pos.y - count) {
-        moving = moveDown(moving);
-        count++;
-    }
-    prev = current;
-    current = moving;
-    incrementScore(2 * count);
-    hardDrop = TRUE;
+    int distance = dropDistance(current);
+    current.pos.y -= distance;
+    LATENCY_ACTION(ACTION_HARD_DROP, current.pos.y);
+    incrementScore(D_SCORE_HARD_DROP * (distance + 1));
+    playSoundEffect(SOUND_HARD_DROP);
+    commit();
 }
 
 // Called in onUpdate when one of the bumpers is pressed to handle tile
 // rotation
-void handleTileRotate() {
-    prev = current;
-    if (keyPressStart(BUTTON_R)) {
+void handleTileRotate(bool clockwise) {
+    unsigned short data = current.data;
+    if (clockwise) {
         current = rotateCW(current);
-    } else if (keyPressStart(BUTTON_L)) {
+    } else {
         current = rotateCCW(current);
     }
+    if (current.data != data) {
+        _resetLockDelay();
+        LATENCY_ACTION(clockwise ? ACTION_ROTATE_CW : ACTION_ROTATE_CCW,
+                current.pos.y);
+        playSoundEffect(SOUND_ROTATE);
+    }
 }
 
-// Called in onUpdate when the user isn't pressing a button so that tile
-// gravity may be applied. Main.c is responsible for timing this call and
-// handles game progression.
+// Called in onUpdate every tick so that tile gravity may be applied. Gravity
+// builds up a fraction of a cell per tick, and once it adds up to one or more
+// whole cells the tile falls that far at once. A tile resting on something
+// locks once it's been there for LOCK_DELAY ticks, so even at 20G there's
+// time to slide it into place. Main.c is responsible for setting the gravity
+// and handles game progression.
 void applyGravity() {
-    prev = current;
-    current = moveDown(current);
-    if (current.pos.y == prev.pos.y) {
+    gravityAccumulator += gravity;
+    int rows = gravityAccumulator >> GRAVITY_SHIFT;
+    gravityAccumulator &= GRAVITY_ONE - 1;
+    
+    int distance = dropDistance(current);
+    if (rows && distance) {
+        current.pos.y -= rows < distance ? rows : distance;
+        distance = dropDistance(current);
+    }
+    
+    if (distance) {
+        lockTimer = 0;
+    } else if (++lockTimer >= LOCK_DELAY) {
+        playSoundEffect(SOUND_LOCK);
         commit();
     }
 }
 
+// Sets how fast tiles fall, in cells per tick (fixed point, see GRAVITY_ONE)
+void setGravity(int cellsPerTick) {
+    gravity = cellsPerTick;
+}
+
+int getGravity() {
+    return gravity;
+}
+
+// Throws away any partial cell of gravity, so the tile waits a full gravity
+// period before it falls again
+void resetGravity() {
+    gravityAccumulator = 0;
+}
+
+// Gives a resting piece its full lock delay again after it's been moved, until
+// it runs out of resets
+static void _resetLockDelay() {
+    if (lockTimer && lockResets) {
+        lockTimer = 0;
+        lockResets--;
+    }
+}
+
 // When a tile is attempted to be moved down 1 tile (whether by the player or
 // by graviity), this function is called to commit its tiles to the gameboard,
 // and to prepare the next piece from the random stack so that it can be placed
 static void commit() {
+    TRACE_EVENT(TRACE_LOCK, current.tile);
+    
     // The order in which these tiles are committed matters, because when
     // gameboard checks cleared rows, it expects them to be sorted. So here, 
     // we need to set the tiles from bottom to top.
@@ -164,17 +234,56 @@ static void commit() {
         }
     }
     
-    // Once the tile has been placed, get the next piece
-    popPiece();
-    prev = current;
+    // Have the piece drawn in its final position, even if it never got drawn
+    // there while it was falling
+    renderPiece(rendered, current, TRUE);
+    rendered = getPentomino(NONE);
+    current = getPentomino(NONE);
+    
+    // Take away any rows it filled. If they flash, the next piece waits until
+    // they're done (see onGameTick). Otherwise it comes in right away.
+    if (!clearFullRows()) {
+        popPiece();
+    }
 }
 
-// Draws the pentomino that the user is currently placing
-void drawPlacingTile() {
-    erasePentomino(prev);
-    drawPentominoOnBoard(current);
-    if (hardDrop) {
-        commit();
-        hardDrop = FALSE;
+// Whether there's a piece in play. There isn't while cleared rows flash.
+bool isPlacing() {
+    return current.tile != NONE;
+}
+
+// Called at the end of every game tick to have the piece drawn wherever it
+// ended up
+void renderPlacingTile() {
+    if (current.tile != rendered.tile
+            || current.pos.x != rendered.pos.x
+            || current.pos.y != rendered.pos.y
+            || current.data != rendered.data) {
+        renderPiece(rendered, current, FALSE);
+        rendered = current;
     }
 }
+
+// Packs up the falling piece and gravity to suspend the game
+void savePlacer(PLACER_STATE *state) {
+    state->x = current.pos.x;
+    state->y = current.pos.y;
+    state->tile = current.tile;
+    state->data = current.data;
+    state->gravity = gravity;
+    state->gravityAccumulator = gravityAccumulator;
+    state->lockTimer = lockTimer;
+    state->lockResets = lockResets;
+}
+
+// Puts the falling piece back when a suspended game is resumed. Nothing is on
+// screen yet, so the next renderPlacingTile draws it.
+void loadPlacer(const PLACER_STATE *state) {
+    current = getPentominoWithPos(state->tile, state->x, state->y);
+    current.data = state->data;
+    rendered = getPentomino(NONE);
+    gravity = state->gravity;
+    gravityAccumulator = state->gravityAccumulator;
+    lockTimer = state->lockTimer;
+    lockResets = state->lockResets;
+}
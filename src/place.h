@@ -1,8 +1,31 @@
-bool isGameStarted();
+// Gravity is measured in cells per tick as a 16.16 fixed point number
+#define GRAVITY_SHIFT 16
+#define GRAVITY_ONE (1 << GRAVITY_SHIFT) // 1G: one cell every tick
+#define MAX_GRAVITY (BOARD_HEIGHT_VISIBLE * GRAVITY_ONE) // 20G
+
+// The falling piece and gravity, packed small for a suspended game
+typedef struct {
+    signed char x;
+    signed char y;
+    unsigned char tile;
+    unsigned short data;
+    int gravity;
+    int gravityAccumulator;
+    unsigned char lockTimer;
+    unsigned char lockResets;
+} PLACER_STATE;
+
 void resetPlacer();
 void popPiece();
-void handleTileMove();
+bool isPlacing();
+void handleTileMove(int direction);
+void handleSoftDrop();
 void handleTileDrop();
-void handleTileRotate();
+void handleTileRotate(bool clockwise);
 void applyGravity();
-void drawPlacingTile();
+void setGravity(int cellsPerTick);
+int getGravity();
+void resetGravity();
+void renderPlacingTile();
+void savePlacer(PLACER_STATE *state);
+void loadPlacer(const PLACER_STATE *state);
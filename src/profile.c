@@ -0,0 +1,156 @@
+#include "gbalib.h"
+#include "clock.h"
+#include "debug.h"
+#include "drawqueue.h"
+#include "music.h"
+#include "scheduler.h"
+#ifdef PCM_SOUND_EFFECTS
+#include "mixer.h"
+#endif
+#include "profile.h"
+
+// A bar HUD_BAR_WIDTH pixels long is a whole frame's worth of cycles
+#define HUD_X 204
+#define HUD_Y 1
+#define HUD_BAR_WIDTH 32
+#define HUD_BAR_HEIGHT 2
+#define HUD_BAR_SPACING 3
+#define HUD_TEXT_Y (HUD_Y + PROFILE_SECTIONS * HUD_BAR_SPACING + 1)
+#define HUD_FLAG_X (HUD_X - 6)
+#define HUD_FLAG_SIZE 4
+#define HUD_BG_COLOR (unsigned short) 0x1084
+#define HUD_DRAW_LINES 6 // rough scanline cost, for the draw queue
+
+// VBlank lasts 68 scanlines, and draws have to be done by then
+#define VBLANK_CYCLES (SCANLINE_CYCLES * 68)
+// How long the overrun flag stays lit, so a single bad frame can be seen
+#define OVERRUN_FLAG_FRAMES 60
+// How often the counters the bars can't show are written to the debug log
+#define LOG_INTERVAL_FRAMES 60
+
+static const unsigned short barColors[PROFILE_SECTIONS] = {
+    GREEN,
+    CYAN,
+    YELLOW
+};
+
+// When each section was last started. Music is refilled from the main loop
+// like everything else, so the sections never overlap.
+static unsigned int sectionStart[PROFILE_SECTIONS];
+// Cycles spent in each section so far this frame, last frame, and at worst
+static unsigned int frameCycles[PROFILE_SECTIONS];
+static unsigned int lastCycles[PROFILE_SECTIONS];
+static unsigned int worstCycles[PROFILE_SECTIONS];
+// The most cycles any whole frame has taken, as a percent of the budget
+static int worstPercent;
+static int overrunTimer;
+static int logTimer;
+
+static void _drawProfile();
+static void _logCounters();
+
+void beginProfile(enum PROFILE_SECTION section) {
+    sectionStart[section] = getCycles();
+}
+
+void endProfile(enum PROFILE_SECTION section) {
+    unsigned int elapsed = getCycles() - sectionStart[section];
+    
+    // Draws start at the beginning of VBlank, so one that took longer than
+    // VBlank was still drawing on screen
+    if (section == PROFILE_DRAW && elapsed > VBLANK_CYCLES) {
+        overrunTimer = OVERRUN_FLAG_FRAMES;
+    }
+    frameCycles[section] += elapsed;
+}
+
+// Called once per pass of the main loop to close off the frame's numbers. They
+// go on screen with the rest of the next VBlank's drawing, so the HUD doesn't
+// tear.
+void endProfileFrame() {
+    unsigned int total = 0;
+    
+    for (int i = 0; i < PROFILE_SECTIONS; i++) {
+        lastCycles[i] = frameCycles[i];
+        frameCycles[i] = 0;
+        if (lastCycles[i] > worstCycles[i]) {
+            worstCycles[i] = lastCycles[i];
+        }
+        total += lastCycles[i];
+    }
+    
+    int percent = total * 100 / FRAME_CYCLES;
+    if (percent > worstPercent) {
+        worstPercent = percent > 999 ? 999 : percent;
+    }
+    
+    queueDraw(_drawProfile, DRAW_DEFERRABLE, HUD_DRAW_LINES);
+    if (overrunTimer) {
+        overrunTimer--;
+    }
+    if (++logTimer >= LOG_INTERVAL_FRAMES) {
+        logTimer = 0;
+        _logCounters();
+    }
+}
+
+// Draws a bar per section, with a tick at the section's worst frame so far,
+// then the worst frame's total as a percent of the budget. A red square lights
+// up for a second after any draw that ran past VBlank.
+static void _drawProfile() {
+    for (int i = 0; i < PROFILE_SECTIONS; i++) {
+        int y = HUD_Y + i * HUD_BAR_SPACING;
+        int length = lastCycles[i] * HUD_BAR_WIDTH / FRAME_CYCLES;
+        int worst = worstCycles[i] * HUD_BAR_WIDTH / FRAME_CYCLES;
+        if (length > HUD_BAR_WIDTH) {
+            length = HUD_BAR_WIDTH;
+        }
+        if (worst >= HUD_BAR_WIDTH) {
+            worst = HUD_BAR_WIDTH - 1;
+        }
+        
+        drawRect(HUD_X, y, HUD_BAR_HEIGHT, HUD_BAR_WIDTH, HUD_BG_COLOR);
+        if (length) {
+            drawRect(HUD_X, y, HUD_BAR_HEIGHT, length, barColors[i]);
+        }
+        drawRect(HUD_X + worst, y, HUD_BAR_HEIGHT, 1, WHITE);
+    }
+    
+    drawRect(HUD_FLAG_X, HUD_Y, HUD_FLAG_SIZE, HUD_FLAG_SIZE,
+            overrunTimer ? RED : HUD_BG_COLOR);
+    
+    // Full screen images can draw over this, so it's drawn every frame
+    drawRect(HUD_X, HUD_TEXT_Y, 8, 4 * 6, HUD_BG_COLOR);
+    drawChar(HUD_X, HUD_TEXT_Y, '0' + worstPercent / 100, WHITE);
+    drawChar(HUD_X + 6, HUD_TEXT_Y, '0' + worstPercent / 10 % 10, WHITE);
+    drawChar(HUD_X + 12, HUD_TEXT_Y, '0' + worstPercent % 10, WHITE);
+    drawChar(HUD_X + 18, HUD_TEXT_Y, '%', WHITE);
+}
+
+// Writes the running totals of things that went wrong to the debug log, once
+// a second. They only ever go up, so a change since the last line shows when
+// it happened. The sound effect mixer's cost per frame, last and at worst,
+// goes on the end when there is one.
+static void _logCounters() {
+    if (!hasDebugLog()) {
+        return;
+    }
+    
+    volatile char *out = DEBUG_LOG_BUFFER;
+    out += writeDebugString(out, "profile skipped=");
+    out += writeDebugDecimal(out, getSkippedFrames());
+    out += writeDebugString(out, " dropped=");
+    out += writeDebugDecimal(out, getDroppedTicks());
+    out += writeDebugString(out, " deferred=");
+    out += writeDebugDecimal(out, getDeferredDraws());
+    out += writeDebugString(out, " underruns=");
+    out += writeDebugDecimal(out, getMusicUnderruns());
+#ifdef PCM_SOUND_EFFECTS
+    out += writeDebugString(out, " mix=");
+    out += writeDebugDecimal(out, getMixerCycles());
+    out += writeDebugString(out, " peak=");
+    out += writeDebugDecimal(out, getMixerPeakCycles());
+#endif
+    *out = '\0';
+    sendDebugLog();
+}
@@ -0,0 +1,24 @@
+// Profiling build (make PROFILE=1). Sections of each frame are timed with the
+// hardware clock and shown as bars in the top right corner of the screen. In
+// normal builds the PROFILE_* macros compile to nothing.
+
+enum PROFILE_SECTION {
+    PROFILE_UPDATE,
+    PROFILE_DRAW,
+    PROFILE_MUSIC,
+    PROFILE_SECTIONS
+};
+
+#ifdef PROFILE
+#define PROFILE_BEGIN(section) beginProfile(section)
+#define PROFILE_END(section) endProfile(section)
+#define PROFILE_FRAME() endProfileFrame()
+#else
+#define PROFILE_BEGIN(section)
+#define PROFILE_END(section)
+#define PROFILE_FRAME()
+#endif
+
+void beginProfile(enum PROFILE_SECTION section);
+void endProfile(enum PROFILE_SECTION section);
+void endProfileFrame();
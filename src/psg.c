@@ -0,0 +1,80 @@
+#include "gbalib.h"
+#include "music.h"
+#include "psg.h"
+
+#define PSG_CHANNELS 3 // square 1, square 2 and noise
+
+// The sequence playing on each channel and how many frames are left in its
+// current step
+static const PSG_STEP *sequences[PSG_CHANNELS];
+static int stepFrames[PSG_CHANNELS];
+
+static void _startSequence(int channel, const PSG_STEP *steps);
+static void _writeStep(int channel, const PSG_STEP *step);
+
+// Turns on the tone and noise channels at full volume and silences them
+void initPsg() {
+    REG_SNDDMGCNT = LEFT_VOL(7) | RIGHT_VOL(7)
+            | CHAN_EN_L(1) | CHAN_EN_R(1)
+            | CHAN_EN_L(2) | CHAN_EN_R(2)
+            | CHAN_EN_L(4) | CHAN_EN_R(4);
+    REG_SND1SWP = 0;
+    REG_SND1CNT = 0;
+    REG_SND2CNT = 0;
+    REG_SND4CNT = 0;
+    for (int i = 0; i < PSG_CHANNELS; i++) {
+        sequences[i] = 0;
+    }
+}
+
+// Starts a sound. Its first step is written right away, and any sequence
+// already playing on the channels it uses is cut off.
+void playPsgPatch(const PSG_PATCH *patch) {
+    // updatePsg can run from the VBlank interrupt, so keep it out while we
+    // change the sequences. Interrupts are left the way the caller had them.
+    unsigned short ime = REG_IME;
+    REG_IME = 0;
+    _startSequence(0, patch->square1);
+    _startSequence(1, patch->square2);
+    _startSequence(2, patch->noise);
+    REG_IME = ime;
+}
+
+// Called once per frame to move each sequence along. Most frames this writes
+// nothing at all.
+void updatePsg() {
+    for (int i = 0; i < PSG_CHANNELS; i++) {
+        if (sequences[i] && --stepFrames[i] <= 0) {
+            sequences[i]++;
+            if (sequences[i]->frames) {
+                _writeStep(i, sequences[i]);
+                stepFrames[i] = sequences[i]->frames;
+            } else {
+                sequences[i] = 0;
+            }
+        }
+    }
+}
+
+static void _startSequence(int channel, const PSG_STEP *steps) {
+    if (steps) {
+        sequences[channel] = steps;
+        stepFrames[channel] = steps->frames;
+        _writeStep(channel, steps);
+    }
+}
+
+// Writes a step's registers and restarts the channel so it takes effect
+static void _writeStep(int channel, const PSG_STEP *step) {
+    if (channel == 0) {
+        REG_SND1SWP = step->sweep;
+        REG_SND1CNT = step->control;
+        REG_SND1FRQ = step->frequency | PSG_RESTART;
+    } else if (channel == 1) {
+        REG_SND2CNT = step->control;
+        REG_SND2FRQ = step->frequency | PSG_RESTART;
+    } else {
+        REG_SND4CNT = step->control;
+        REG_SND4FRQ = step->frequency | PSG_RESTART;
+    }
+}
@@ -0,0 +1,32 @@
+// Field helpers for the legacy sound registers in music.h
+#define PSG_RATE(hz)                (2048 - 131072 / (hz)) // square channels
+#define PSG_NOISE(shift, ratio)     (((shift) << 4) | (ratio))
+#define PSG_ENV(volume, stepTime)   (((volume) << 12) | ((stepTime) << 8))
+#define PSG_ENV_UP                  (1 << 11)
+#define PSG_DUTY_12                 (0 << 6)
+#define PSG_DUTY_25                 (1 << 6)
+#define PSG_DUTY_50                 (2 << 6)
+#define PSG_SWEEP(time, shift)      (((time) << 4) | (shift))
+#define PSG_SWEEP_DOWN              (1 << 3)
+#define PSG_RESTART                 (1 << 15)
+
+// One step of a sequence for a single channel. The hardware envelope and
+// sweep take care of everything within a step, so the sequencer only has to
+// write the registers when a step starts.
+typedef struct {
+    unsigned char frames;      // how long until the next step, 0 ends it
+    unsigned char sweep;       // REG_SND1SWP, only used by square channel 1
+    unsigned short control;    // REG_SNDxCNT: envelope, duty and length
+    unsigned short frequency;  // REG_SNDxFRQ
+} PSG_STEP;
+
+// A sound made of up to one sequence per channel (0 for unused channels)
+typedef struct {
+    const PSG_STEP *square1;
+    const PSG_STEP *square2;
+    const PSG_STEP *noise;
+} PSG_PATCH;
+
+void initPsg();
+void playPsgPatch(const PSG_PATCH *patch);
+void updatePsg();
@@ -0,0 +1,35 @@
+#include "random.h"
+
+// xorshift can't leave a state of zero, so that seed is swapped for this one
+#define ZERO_SEED 0x9E3779B9
+
+void seedRandom(RANDOM *random, unsigned int seed) {
+    random->state = seed ? seed : ZERO_SEED;
+}
+
+// Marsaglia's 32-bit xorshift, which repeats after 2^32 - 1 numbers
+unsigned int nextRandom(RANDOM *random) {
+    unsigned int x = random->state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    random->state = x;
+    return x;
+}
+
+// Returns a number from 0 to bound - 1, with every one equally likely. The
+// random word is scaled into range with a multiply instead of a modulo, and
+// the few words that would make some results more likely than others are
+// thrown out, which hardly ever needs the slow division.
+int randomBelow(RANDOM *random, int bound) {
+    unsigned long long scaled = (unsigned long long) nextRandom(random) * bound;
+    unsigned int low = (unsigned int) scaled;
+    if (low < (unsigned int) bound) {
+        unsigned int threshold = -(unsigned int) bound % bound;
+        while (low < threshold) {
+            scaled = (unsigned long long) nextRandom(random) * bound;
+            low = (unsigned int) scaled;
+        }
+    }
+    return scaled >> 32;
+}
@@ -0,0 +1,10 @@
+// A small xorshift generator. Its whole state is one word that can be saved
+// and restored, and it only uses shifts and exclusive ors, so the same seed
+// gives the same numbers on the GBA and on any host.
+typedef struct {
+    unsigned int state;
+} RANDOM;
+
+void seedRandom(RANDOM *random, unsigned int seed);
+unsigned int nextRandom(RANDOM *random);
+int randomBelow(RANDOM *random, int bound);
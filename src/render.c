@@ -0,0 +1,158 @@
+#include "gbalib.h"
+#include "gameboard.h"
+#include "pentomino.h"
+#include "dashboard.h"
+#include "input.h"
+#include "latency.h"
+#include "render.h"
+
+static RENDER_COMMAND commands[RENDER_QUEUE_SIZE];
+static int commandCount;
+// Set if commands had to be dropped because the queue was full. The next batch
+// then redraws everything they could have changed.
+static bool overflowed;
+// The last piece and banner asked for, to redraw after an overflow
+static PENTOMINO latestPiece;
+static int latestBanner;
+// The falling piece as it's drawn on screen right now
+static PENTOMINO onScreen;
+
+static void _push(enum RENDER_OP op, PENTOMINO pent, unsigned int arg);
+static PENTOMINO _pieceOf(RENDER_COMMAND *command);
+static bool _isCommandFor(RENDER_COMMAND *command, PENTOMINO pent);
+
+// Queues a command that isn't about a piece
+void renderCommand(enum RENDER_OP op, unsigned int arg) {
+    if (op == RENDER_BANNER) {
+        latestBanner = arg;
+    }
+    _push(op, getPentomino(NONE), arg);
+}
+
+// Moves the falling piece on screen. Either end can be an empty pentomino, for
+// a piece that's just spawned or one that was committed somewhere else. If the
+// piece hasn't been drawn where it's moving from yet, that draw is dropped
+// rather than drawn and erased in the same batch. A locked piece stays on the
+// board instead of being the falling piece.
+void renderPiece(PENTOMINO from, PENTOMINO to, bool lock) {
+    if (from.tile != NONE) {
+        if (commandCount
+                && commands[commandCount - 1].op == RENDER_DRAW_PIECE
+                && _isCommandFor(&commands[commandCount - 1], from)) {
+            commandCount--;
+        } else {
+            _push(RENDER_ERASE_PIECE, from, from.data);
+        }
+    }
+    
+    if (to.tile != NONE) {
+        _push(lock ? RENDER_LOCK_PIECE : RENDER_DRAW_PIECE, to, to.data);
+    }
+    latestPiece = lock ? getPentomino(NONE) : to;
+}
+
+// Whether a command of some kind is waiting to be run
+bool isRenderPending(enum RENDER_OP op) {
+    for (int i = 0; i < commandCount; i++) {
+        if (commands[i].op == op) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Runs every queued command in the order it was queued. Called from onDraw at
+// the start of VBlank, before the draw queue is run, so anything a command
+// queues up is drawn in the same VBlank.
+void runRenderCommands() {
+    for (int i = 0; i < commandCount; i++) {
+        RENDER_COMMAND *command = &commands[i];
+        switch (command->op) {
+            case RENDER_ERASE_PIECE:
+                erasePentomino(_pieceOf(command));
+                onScreen = getPentomino(NONE);
+                break;
+            case RENDER_DRAW_PIECE:
+                onScreen = _pieceOf(command);
+                drawPentominoOnBoard(onScreen);
+                break;
+            case RENDER_LOCK_PIECE:
+                drawPentominoOnBoard(_pieceOf(command));
+                break;
+            case RENDER_FLASH_ROWS:
+                flashRows(command->arg);
+                break;
+            case RENDER_REDRAW_ROWS:
+                redrawRows(command->arg);
+                break;
+            case RENDER_SCORE:
+                showScore();
+                break;
+            case RENDER_BANNER:
+                showBanner(command->arg);
+                break;
+        }
+    }
+    commandCount = 0;
+    
+    if (overflowed) {
+        // Too much changed to keep track of, so start the picture over
+        redrawEntireBoard();
+        onScreen = latestPiece;
+        if (onScreen.tile != NONE) {
+            drawPentominoOnBoard(onScreen);
+        }
+        showScore();
+        showBanner(latestBanner);
+        overflowed = FALSE;
+    }
+    LATENCY_DRAWN();
+}
+
+// Throws away any queued commands, for when the whole screen is about to be
+// redrawn anyway
+void clearRenderCommands() {
+    commandCount = 0;
+    overflowed = FALSE;
+    latestPiece = getPentomino(NONE);
+    latestBanner = 0;
+    onScreen = getPentomino(NONE);
+}
+
+// Puts the falling piece back over a board row that's just been redrawn. Only
+// its tiles in that row are drawn, since a row being raced may be just above
+// rows the display hasn't scanned past yet. A pentomino reaches at most two
+// rows either side of its center.
+void drawPieceOverRow(int row) {
+    if (onScreen.tile != NONE
+            && row >= onScreen.pos.y - 2 && row <= onScreen.pos.y + 2) {
+        drawPentominoRowOnBoard(onScreen, row);
+    }
+}
+
+static void _push(enum RENDER_OP op, PENTOMINO pent, unsigned int arg) {
+    if (commandCount == RENDER_QUEUE_SIZE) {
+        overflowed = TRUE;
+        return;
+    }
+    
+    RENDER_COMMAND *command = &commands[commandCount++];
+    command->op = op;
+    command->tile = pent.tile;
+    command->x = pent.pos.x;
+    command->y = pent.pos.y;
+    command->arg = arg;
+}
+
+static PENTOMINO _pieceOf(RENDER_COMMAND *command) {
+    PENTOMINO pent = getPentominoWithPos(command->tile, command->x, command->y);
+    pent.data = command->arg;
+    return pent;
+}
+
+static bool _isCommandFor(RENDER_COMMAND *command, PENTOMINO pent) {
+    return command->tile == pent.tile
+            && command->x == pent.pos.x
+            && command->y == pent.pos.y
+            && command->arg == pent.data;
+}
@@ -0,0 +1,33 @@
+// Game logic doesn't draw anything itself. As a tick changes what should be on
+// screen, it describes the change as a render command, and onDraw plays the
+// commands back in VBlank as one batch. If the piece moves several times
+// between two draws, only the last move is drawn.
+
+enum RENDER_OP {
+    RENDER_ERASE_PIECE, // clear the falling piece off the board
+    RENDER_DRAW_PIECE,  // draw the falling piece
+    RENDER_LOCK_PIECE,  // draw a piece that's been committed to the board
+    RENDER_FLASH_ROWS,  // flash the board rows in arg's mask white
+    RENDER_REDRAW_ROWS, // redraw the board rows in arg's mask
+    RENDER_SCORE,       // redraw the score
+    RENDER_BANNER       // show the cleared lines indicator for arg lines
+};
+
+#define RENDER_QUEUE_SIZE 64
+
+// Commands for pieces keep the pentomino in the position fields, with its data
+// in arg. Other commands only use arg.
+typedef struct {
+    unsigned char op;
+    unsigned char tile;
+    signed char x;
+    signed char y;
+    unsigned int arg;
+} RENDER_COMMAND;
+
+void renderCommand(enum RENDER_OP op, unsigned int arg);
+void renderPiece(PENTOMINO from, PENTOMINO to, bool lock);
+bool isRenderPending(enum RENDER_OP op);
+void runRenderCommands();
+void clearRenderCommands();
+void drawPieceOverRow(int row);
@@ -0,0 +1,118 @@
+#include "gbalib.h"
+#include "clock.h"
+#include "irq.h"
+#include "debug.h"
+#include "sampler.h"
+
+// Code is linked ahead of the images and music in ROM, so only the start of
+// ROM is covered. IWRAM code sits at the very start of IWRAM. Each bucket of
+// the histogram covers one ARM or two Thumb instructions.
+#define ROM_CODE_START   0x8000000
+#define ROM_CODE_SIZE    0x10000
+#define IWRAM_CODE_START 0x3000000
+#define IWRAM_CODE_SIZE  0x2000
+#define BUCKET_SHIFT     2
+#define BUCKET_MAX       0xFFFF
+
+static unsigned short romSamples[ROM_CODE_SIZE >> BUCKET_SHIFT] EWRAM_BSS;
+static unsigned short iwramSamples[IWRAM_CODE_SIZE >> BUCKET_SHIFT] EWRAM_BSS;
+// Samples anywhere else, like the BIOS, or in a full bucket
+static unsigned int otherSamples;
+static unsigned int totalSamples;
+
+static int sampleInterval;
+static int sampleCountdown;
+// The handler that had the clock's interrupt before us
+static irqptr chainedHandler;
+
+static void _sample();
+static void _clearSamples();
+static void _dumpBuckets(const unsigned short *buckets, int count,
+        unsigned int start);
+
+// Starts sampling every interval overflows of the clock. The clock's interrupt
+// is shared, so this has to come after anything else that uses it.
+void initSampler(int interval) {
+    _clearSamples();
+    sampleInterval = interval;
+    sampleCountdown = interval;
+    chainedHandler = getInterruptHandler(CLOCK_OVERFLOW_IRQ);
+    setInterruptHandler(CLOCK_OVERFLOW_IRQ, _sample);
+    enableInterrupt(CLOCK_OVERFLOW_IRQ);
+}
+
+// Writes the histogram to the debug log and starts a new one. There can be
+// thousands of lines, so this takes a while and is only done between games.
+// The first line is "samples total other", then one "sample address count"
+// line per bucket that was hit, all in hex.
+void dumpSamples() {
+    if (hasDebugLog()) {
+        volatile char *out = DEBUG_LOG_BUFFER;
+        out += writeDebugString(out, "samples ");
+        out += writeDebugHex(out, totalSamples, 8);
+        *out++ = ' ';
+        out += writeDebugHex(out, otherSamples, 8);
+        *out = '\0';
+        sendDebugLog();
+        
+        _dumpBuckets(romSamples, ROM_CODE_SIZE >> BUCKET_SHIFT,
+                ROM_CODE_START);
+        _dumpBuckets(iwramSamples, IWRAM_CODE_SIZE >> BUCKET_SHIFT,
+                IWRAM_CODE_START);
+    }
+    _clearSamples();
+}
+
+// Called on every overflow of the clock
+static void _sample() {
+    if (--sampleCountdown <= 0) {
+        sampleCountdown = sampleInterval;
+        
+        unsigned int pc = getInterruptedPc();
+        unsigned short *bucket = 0;
+        if (pc - ROM_CODE_START < ROM_CODE_SIZE) {
+            bucket = &romSamples[(pc - ROM_CODE_START) >> BUCKET_SHIFT];
+        } else if (pc - IWRAM_CODE_START < IWRAM_CODE_SIZE) {
+            bucket = &iwramSamples[(pc - IWRAM_CODE_START) >> BUCKET_SHIFT];
+        }
+        
+        if (bucket && *bucket < BUCKET_MAX) {
+            (*bucket)++;
+        } else {
+            otherSamples++;
+        }
+        totalSamples++;
+    }
+    
+    if (chainedHandler) {
+        chainedHandler();
+    }
+}
+
+static void _clearSamples() {
+    REG_IME &= ~IRQ_ENABLE;
+    for (int i = 0; i < ROM_CODE_SIZE >> BUCKET_SHIFT; i++) {
+        romSamples[i] = 0;
+    }
+    for (int i = 0; i < IWRAM_CODE_SIZE >> BUCKET_SHIFT; i++) {
+        iwramSamples[i] = 0;
+    }
+    otherSamples = 0;
+    totalSamples = 0;
+    REG_IME |= IRQ_ENABLE;
+}
+
+static void _dumpBuckets(const unsigned short *buckets, int count,
+        unsigned int start) {
+    for (int i = 0; i < count; i++) {
+        if (buckets[i]) {
+            volatile char *out = DEBUG_LOG_BUFFER;
+            out += writeDebugString(out, "sample ");
+            out += writeDebugHex(out, start + (i << BUCKET_SHIFT), 8);
+            *out++ = ' ';
+            out += writeDebugHex(out, buckets[i], 4);
+            *out = '\0';
+            sendDebugLog();
+        }
+    }
+}
@@ -0,0 +1,16 @@
+// Sampling profiler (make PROFILE_SAMPLES=n). On every nth overflow of the
+// clock, where n = 1 is 256 times a second, the address the CPU was at is
+// counted in a histogram. The histogram is written to the debug log when a
+// game ends, and tools/profsym.py matches it up with functions from
+// Pentris.map. In normal builds the SAMPLER macros compile to nothing.
+
+#ifdef PROFILE_SAMPLES
+#define SAMPLER_INIT() initSampler(PROFILE_SAMPLES)
+#define SAMPLER_DUMP() dumpSamples()
+#else
+#define SAMPLER_INIT()
+#define SAMPLER_DUMP()
+#endif
+
+void initSampler(int interval);
+void dumpSamples();
@@ -0,0 +1,182 @@
+#include <stddef.h>
+
+#include "gbalib.h"
+#include "save.h"
+
+// Emulators and flash carts look for this string in the ROM to tell that the
+// game saves to SRAM
+static const char saveType[] __attribute__((used, aligned(4))) = "SRAM_V113";
+
+// What's saved, as the game sees it
+static SAVE_RECORD record;
+// The copy being written out, how much of it has been written, and which slot
+// it's going to
+static SAVE_RECORD writing;
+static int writePosition;
+static int writeSlot;
+static bool writeActive;
+// Set when there's something new to save that hasn't started writing yet
+static bool saveQueued;
+
+static bool _readSlot(int slot, SAVE_RECORD *out);
+
+// Loads the newest good save from SRAM. If there isn't one, like the first
+// time the game is played, there are no high scores and the settings are the
+// defaults.
+void initSave(SETTINGS defaults) {
+    SAVE_RECORD slots[2];
+    bool valid[2];
+    for (int i = 0; i < 2; i++) {
+        valid[i] = _readSlot(i, &slots[i]);
+    }
+    
+    // The sequence number wraps around, so newer is whichever one is ahead
+    if (valid[0] && (!valid[1]
+            || (int) (slots[0].sequence - slots[1].sequence) > 0)) {
+        record = slots[0];
+        writeSlot = 1;
+    } else if (valid[1]) {
+        record = slots[1];
+        writeSlot = 0;
+    } else {
+        for (int i = 0; i < HIGH_SCORE_COUNT; i++) {
+            record.highScores[i] = 0;
+        }
+        record.settings = defaults;
+        record.sequence = 0;
+        writeSlot = 0;
+    }
+    
+    writeActive = FALSE;
+    saveQueued = FALSE;
+}
+
+// Asks for everything to be saved. Nothing is written until updateSave runs,
+// and then only a bit at a time.
+void queueSave() {
+    saveQueued = TRUE;
+}
+
+// Called once a frame to write the next few bytes of a save. When nothing is
+// being written and a save has been queued, this takes a copy of the record
+// to write.
+void updateSave() {
+    if (!writeActive) {
+        if (!saveQueued) {
+            return;
+        }
+    
+        record.sequence++;
+        writing = record;
+        writing.magic = SAVE_MAGIC;
+        writing.version = SAVE_VERSION;
+        writing.checksum = checksumSave(
+                &writing, sizeof(SAVE_RECORD), offsetof(SAVE_RECORD, checksum));
+        writePosition = 0;
+        writeActive = TRUE;
+        saveQueued = FALSE;
+    }
+    
+    const unsigned char *bytes = (const unsigned char*) &writing;
+    volatile unsigned char *slot = SRAM + writeSlot * SAVE_SLOT_SIZE;
+    int end = writePosition + SAVE_BYTES_PER_FRAME;
+    if (end > (int) sizeof(SAVE_RECORD)) {
+        end = sizeof(SAVE_RECORD);
+    }
+    
+    for (; writePosition < end; writePosition++) {
+        slot[writePosition] = bytes[writePosition];
+    }
+    
+    if (writePosition == sizeof(SAVE_RECORD)) {
+        // The next save overwrites the older copy, which is now the other one
+        writeSlot ^= 1;
+        writeActive = FALSE;
+    }
+}
+
+// Whether there's a save that hasn't finished being written
+bool isSaving() {
+    return writeActive || saveQueued;
+}
+
+// Adds a score to the high scores if it's good enough, and saves them if it
+// is. Returns whether it made the list.
+bool addHighScore(unsigned int score) {
+    int rank = HIGH_SCORE_COUNT;
+    while (rank > 0 && score > record.highScores[rank - 1]) {
+        rank--;
+    }
+    if (rank == HIGH_SCORE_COUNT) {
+        return FALSE;
+    }
+    
+    for (int i = HIGH_SCORE_COUNT - 1; i > rank; i--) {
+        record.highScores[i] = record.highScores[i - 1];
+    }
+    record.highScores[rank] = score;
+    queueSave();
+    return TRUE;
+}
+
+// The high score at a rank, with 0 being the best
+unsigned int getHighScore(int rank) {
+    return record.highScores[rank];
+}
+
+SETTINGS getSettings() {
+    return record.settings;
+}
+
+// Changes the settings, and saves them if they're different
+void setSettings(SETTINGS settings) {
+    if (settings.startingGravity != record.settings.startingGravity
+            || settings.bagPieces != record.settings.bagPieces) {
+        record.settings = settings;
+        queueSave();
+    }
+}
+
+// Copies bytes out of SRAM
+void readSram(int offset, void *out, int size) {
+    unsigned char *bytes = out;
+    for (int i = 0; i < size; i++) {
+        bytes[i] = SRAM[offset + i];
+    }
+}
+
+// Copies bytes into SRAM all at once. This is only for a few hundred bytes,
+// which is a small part of a frame. Anything that can wait should be saved
+// with queueSave instead.
+void writeSram(int offset, const void *data, int size) {
+    const unsigned char *bytes = data;
+    for (int i = 0; i < size; i++) {
+        SRAM[offset + i] = bytes[i];
+    }
+}
+
+// Fletcher-16 over a saved record, skipping its two byte checksum at skip
+unsigned short checksumSave(const void *data, int size, int skip) {
+    const unsigned char *bytes = data;
+    unsigned int a = 0;
+    unsigned int b = 0;
+    for (int i = 0; i < size; i++) {
+        if (i == skip) {
+            i++;
+            continue;
+        }
+        a = (a + bytes[i]) % 255;
+        b = (b + a) % 255;
+    }
+    return (b << 8) | a;
+}
+
+// Reads a slot out of SRAM, and checks that it's a save from this version
+// that was written all the way through
+static bool _readSlot(int slot, SAVE_RECORD *out) {
+    readSram(slot * SAVE_SLOT_SIZE, out, sizeof(SAVE_RECORD));
+    return out->magic == SAVE_MAGIC
+            && out->version == SAVE_VERSION
+            && out->checksum == checksumSave(
+                    out, sizeof(SAVE_RECORD), offsetof(SAVE_RECORD, checksum));
+}
@@ -0,0 +1,42 @@
+// High scores and settings are kept in the cartridge's battery-backed SRAM.
+// SRAM is on an 8-bit bus and has to be written a byte at a time, so saving
+// is done in the background: queueSave asks for a save, and updateSave takes
+// a copy of what's to be saved and writes a few bytes of it every frame.
+//
+// There are two copies of the save in SRAM, and each save goes to the older
+// one. If the power goes out partway through a save, the other copy is still
+// whole, and the checksum tells them apart.
+#define SRAM ((volatile unsigned char*) 0x0E000000)
+
+#define SAVE_MAGIC 0x53544E50 // "PNTS"
+#define SAVE_VERSION 1
+#define SAVE_SLOT_SIZE 0x100 // two slots, at the start of SRAM
+#define SAVE_BYTES_PER_FRAME 16
+
+#define HIGH_SCORE_COUNT 5
+
+typedef struct {
+    int startingGravity;
+    bool bagPieces;
+} SETTINGS;
+
+typedef struct {
+    unsigned int magic;
+    unsigned short version;
+    unsigned short checksum;
+    unsigned int sequence; // which of the two copies is newer
+    unsigned int highScores[HIGH_SCORE_COUNT];
+    SETTINGS settings;
+} SAVE_RECORD;
+
+void initSave(SETTINGS defaults);
+void queueSave();
+void updateSave();
+bool isSaving();
+bool addHighScore(unsigned int score);
+unsigned int getHighScore(int rank);
+SETTINGS getSettings();
+void setSettings(SETTINGS settings);
+void readSram(int offset, void *out, int size);
+void writeSram(int offset, const void *data, int size);
+unsigned short checksumSave(const void *data, int size, int skip);
@@ -0,0 +1,69 @@
+#include "gbalib.h"
+#include "clock.h"
+#include "scheduler.h"
+#include "trace.h"
+
+// The clock reading at which the most recent game tick was due
+static unsigned int lastTick;
+// How many draws were skipped because a frame's work overran into the next one
+static int skippedFrames;
+// How many ticks were thrown away because we fell too far behind to catch up
+static int droppedTicks;
+
+// Aligns the game ticks with the display. Ticks are placed half a frame away
+// from the start of VBlank so that the main loop, which always asks for due
+// ticks just after drawing in VBlank, never lands right on a tick boundary
+// and jitters between running zero and two ticks.
+void initScheduler() {
+    resyncScheduler();
+    skippedFrames = 0;
+    droppedTicks = 0;
+}
+
+// Lines the ticks back up with the display from here on, forgetting any time
+// that's gone by since the last one. Used after the game has been paused,
+// when there's nothing to catch up on.
+void resyncScheduler() {
+    waitForVblank();
+    lastTick = getCycles() - FRAME_CYCLES / 2;
+}
+
+// Returns how many game ticks have come due since this was last called. The
+// game logic is run at exactly one tick per FRAME_CYCLES of the hardware
+// clock, regardless of how long drawing takes. Normally this returns 1, but if
+// the last draw ran long and we missed a VBlank, the missed ticks are returned
+// so the game can catch up instead of slowing down.
+int getDueTicks() {
+    unsigned int now = getCycles();
+    int ticks = 0;
+    
+    while (now - lastTick >= FRAME_CYCLES) {
+        lastTick += FRAME_CYCLES;
+        ticks++;
+    }
+    
+    if (ticks > MAX_TICKS_PER_FRAME) {
+        droppedTicks += ticks - MAX_TICKS_PER_FRAME;
+        TRACE_EVENT(TRACE_DROPPED, ticks - MAX_TICKS_PER_FRAME);
+        ticks = MAX_TICKS_PER_FRAME;
+    }
+    
+    // Every tick past the first is a frame that didn't get its own draw
+    if (ticks > 1) {
+        skippedFrames += ticks - 1;
+        TRACE_EVENT(TRACE_OVERRUN, ticks - 1);
+    }
+    
+    return ticks;
+}
+
+// The number of draws that have been coalesced into a later frame
+int getSkippedFrames() {
+    return skippedFrames;
+}
+
+// The number of ticks that were never simulated because the game fell more
+// than MAX_TICKS_PER_FRAME behind
+int getDroppedTicks() {
+    return droppedTicks;
+}
@@ -0,0 +1,9 @@
+// The most game ticks that will be run to catch up after a slow frame. Any
+// time beyond this is dropped instead of being simulated.
+#define MAX_TICKS_PER_FRAME 4
+
+void initScheduler();
+void resyncScheduler();
+int getDueTicks();
+int getSkippedFrames();
+int getDroppedTicks();
@@ -0,0 +1,2 @@
+#define SFX_GAME_OVER_LENGTH 16819
+extern const signed char SFX_GAME_OVER_data[16819];
@@ -0,0 +1,160 @@
+const signed char SFX_HARD_DROP_data[2522] = {
+0, 1, -1, -1, 3, 3, 4, 2, 5, 6, 7, 2, 6, 6, 12, 18,
+17, 10, 7, 3, -4, -6, 4, -1, -1, 13, 0, -1, -14, -24, -16, -25,
+-13, 4, -10, -33, -4, -9, -12, -4, -11, -9, -31, 2, 3, -38, -4, -3,
+-15, -8, -8, 23, 0, 25, -2, 37, 42, 17, 28, 56, 46, 31, 14, 23,
+54, 13, 72, 21, 73, 22, 75, 52, 31, 29, 37, 27, -3, -18, 5, 40,
+5, -54, 14, -1, 12, -66, -13, -89, -31, -74, -82, -13, -99, -53, -15, -84,
+-86, -5, -56, -16, -94, -49, -67, 2, -65, 52, -59, 38, -45, -8, 69, -8,
+2, 71, 37, -2, 120, 17, 4, 43, 77, 92, 11, 37, -5, 43, 78, 70,
+84, 60, 66, 40, 4, -34, 13, -36, -70, -34, 13, -85, -34, -62, -51, -100,
+-2, -90, -48, -71, -120, -52, -101, -108, -107, -88, -91, -19, -29, 35, 35, 49,
+-36, -3, -20, 28, 38, 66, 60, 11, 36, 53, -7, 0, 47, 13, 87, 29,
+11, 19, 23, 18, 50, 39, 16, 50, -7, 70, 70, 36, -6, -4, -2, -71,
+-34, -27, -73, -88, -9, -65, -50, -5, -44, -83, -2, -73, -113, -34, -100, -73,
+-7, -22, -94, -38, -37, -22, -48, 2, -51, -20, -3, 68, -25, 59, -1, 48,
+31, 43, 80, 41, 12, 13, 9, 97, 72, 107, 74, -5, 64, 73, 63, 32,
+11, 16, 49, -17, 6, -6, 42, 18, 27, 11, -55, -67, -43, -72, -57, -31,
+-7, -45, -20, -101, -71, 2, -91, -58, -94, -88, 6, 21, -12, -64, -40, -41,
+13, 20, 0, 15, -24, 28, 78, 62, -6, 44, 69, 22, 94, 49, 76, 44,
+108, 84, 60, 11, 41, -7, 50, 77, -3, 27, 19, 5, 32, 51, 20, -11,
+36, -37, 2, -12, -6, -1, -71, -32, -58, -32, -1, -38, -105, -56, -29, -10,
+-32, -12, -93, 8, -10, -19, 17, 20, -57, 24, 24, -29, 33, 22, -14, 55,
+-9, 44, 30, 15, 51, 43, 18, 98, 7, 0, 50, 85, 65, 73, 43, 60,
+22, 11, 31, -22, -22, 42, -23, 31, 29, -15, 7, 13, 16, -63, -64, -46,
+-42, -62, -93, -41, -1, -63, -46, -62, -55, -11, -66, -30, -44, -35, 6, -74,
+5, -42, -4, 16, 7, -13, 36, -33, 26, 7, 25, 61, 60, 47, 19, 15,
+40, 20, 26, 93, 11, 80, 36, 34, 28, 2, 36, 5, 28, 10, 64, 62,
+11, 25, 48, -15, -41, -33, -43, 0, -34, -40, -2, -59, -8, -27, -52, -14,
+-61, -11, -7, -47, -29, -3, -21, -18, -5, 4, -9, 15, -45, -10, -1, -25,
+-17, -33, 45, -7, 9, 53, -9, 67, -6, -12, 22, 25, 79, 78, 68, 39,
+50, 22, 76, 35, 24, 54, 7, 20, 73, -7, -6, -4, -4, 7, -13, -9,
+-23, -28, 1, -28, -29, 2, -65, -61, -1, -42, -13, -73, -40, -12, -59, -21,
+-35, -53, 1, -51, -42, -27, -51, -2, -20, -17, -18, 26, 30, 22, -8, -7,
+7, -31, -21, 61, -11, 63, 44, 68, -2, 20, 65, -2, 8, 30, 15, 13,
+57, 7, 81, 52, -2, 68, 9, 26, 30, -10, 17, -25, -17, 40, 28, -2,
+7, 20, -47, -21, -55, -59, -63, -57, -73, -61, -49, -30, -11, -8, -24, -41,
+-6, -68, -71, -10, -23, -55, -39, -42, -28, -24, -23, 14, 19, 3, -1, -12,
+32, 54, -5, 38, 41, 40, -8, 37, 11, 12, 45, 51, 50, 60, 57, 38,
+3, 60, 63, 62, 40, -7, 2, -8, 31, 21, -12, 46, 44, 34, -5, -23,
+-33, 12, -1, -38, 8, -21, -36, -38, -16, -39, -25, -68, -23, -57, -7, -61,
+-51, -34, -44, -32, 2, -52, -5, -9, 2, -21, -17, -22, -8, -22, -23, 3,
+-15, 10, 21, 4, -3, 33, 55, 9, 41, 46, 65, 50, 23, 16, 64, 22,
+0, 64, 12, 19, 18, 11, 44, 12, 17, 12, 40, -24, 14, -23, -25, 6,
+-15, -42, -6, 15, -8, -22, -2, 4, -55, -46, 1, -3, -57, -21, -9, -30,
+-22, -34, -54, -55, -64, -18, -54, -17, -31, -25, 16, -22, -13, -17, -25, -21,
+5, 28, -21, 44, 28, -14, 36, 17, 27, 0, 31, 33, 53, 40, 49, 52,
+16, 2, 33, 8, 8, 19, 32, 36, 36, 54, -7, 22, -14, 24, 5, -19,
+-11, 10, -6, 24, -20, -24, 13, -11, -48, -4, -35, 3, -20, -10, -5, -32,
+-2, -66, -45, -11, -66, -21, 3, -15, -4, -55, -21, -15, -24, -22, 5, -34,
+-39, 1, 29, 23, 16, -7, 37, -18, -1, 37, 47, 16, 52, 1, 35, 1,
+13, 11, 0, 26, 33, 18, 42, 2, 31, 31, 21, 53, -1, 17, 17, 9,
+45, 16, 10, 2, -1, 29, 16, 4, -30, -5, -38, -26, -49, -8, 7, -16,
+-22, -44, -33, -32, -36, -46, -49, -16, -3, -10, -22, -58, -40, -5, 5, -19,
+-16, -6, -31, 0, -19, 14, -7, 8, 4, 5, 4, 36, 27, 9, 16, 43,
+35, 32, 52, 2, 33, 36, 26, 58, 58, 24, 37, 46, 41, 20, 45, 17,
+4, 33, 30, 14, 17, 44, 31, 5, 32, 10, -3, 9, 14, 18, 2, 0,
+-18, -42, -19, -41, 5, -30, -18, -12, -45, -8, -38, -53, -23, -34, -5, -31,
+-51, -55, -53, -25, -11, -47, -30, -19, 7, 13, 10, -1, -3, -20, 4, -19,
+-8, 24, 11, 23, 10, 2, 16, 22, 6, 41, 50, 6, 11, 43, 39, 12,
+32, 13, 47, 32, 27, 7, 20, 22, 15, 3, 3, 29, 39, 32, 18, 25,
+-13, -11, 14, -26, -24, 11, -23, -26, -16, 5, -41, 4, -29, -16, -23, -43,
+1, -42, -9, -6, -29, -2, -49, -45, -27, -47, -8, -22, -7, -32, -44, 2,
+-32, -19, -32, -6, -11, -22, -28, -11, 14, -16, -10, 12, 15, 26, 20, 32,
+-2, 39, -5, 1, 1, 36, 24, 45, 48, 48, 31, 18, 48, 36, 9, 26,
+-1, -3, 27, 30, 36, 29, -4, 24, 35, 18, 6, -5, -18, 7, 22, -22,
+11, 12, -16, 6, -29, -24, -13, 1, -17, -39, 0, -18, -9, -36, -31, -43,
+-39, -27, -28, -16, -7, -30, -1, -13, -27, -33, 5, -8, -35, -3, -16, -12,
+6, -18, -14, 1, 20, -16, 20, 17, -7, 17, 17, 23, 16, 7, 17, 6,
+17, 16, 3, 9, 15, 18, 25, 34, 12, 25, 14, 9, 4, 40, 38, 32,
+2, 0, -4, 3, 7, -13, 4, 14, 19, -11, -22, 12, -8, -13, -22, -18,
+-20, -22, -24, -13, -2, -25, -21, -19, -5, -8, 0, -35, -8, -30, -18, -20,
+-18, -28, -38, -40, -1, -1, -19, -33, 0, -13, -13, -5, -23, -19, 7, 6,
+18, -4, 20, 18, 4, 22, -7, -9, 23, -3, 13, 24, 22, 5, 29, -1,
+21, 35, 21, 12, 40, 29, 32, 36, 37, 22, 32, 18, 8, 8, 6, -4,
+18, 8, 28, -8, 20, -5, -1, -4, 21, 7, -2, -14, -21, -10, 12, -10,
+-2, 4, -29, -20, -17, -25, -20, -10, -31, -10, -26, -13, -31, -8, -22, -6,
+-1, -15, -36, -23, 1, -10, -6, -15, 3, 3, -7, -7, -24, -26, -17, 3,
+9, 8, 14, -17, -15, -6, -13, 9, 23, 23, -5, 17, 18, 19, 11, 5,
+29, 31, 24, 19, 1, 10, 9, 9, 8, 24, 24, 6, 31, -2, 32, 18,
+19, 5, 19, 24, 0, -4, 18, -2, -8, 4, -8, -8, -7, -15, 9, -1,
+0, -13, 2, 7, 8, -26, -18, -26, -14, -9, -11, -20, 0, -12, 0, -19,
+-12, -30, -16, -12, -25, -12, -28, -16, -11, -15, -25, -23, -16, -6, -12, -18,
+-13, -13, -17, -1, -4, -8, -17, 14, -13, -10, -3, 14, 20, 16, -1, 20,
+-5, -1, -1, 14, 16, 18, 28, 23, 23, 5, 28, 29, 26, 2, 22, 16,
+16, 7, 23, 23, 21, 6, 19, -2, 16, -5, -7, -5, 11, 20, 3, 8,
+5, 11, 14, 8, -7, -16, 7, -12, 1, 4, -18, -18, -12, 0, -1, 3,
+-19, -9, -2, -17, -11, -22, -4, -16, -15, -10, -20, -5, -15, -15, -7, -8,
+-6, -1, -2, -13, -5, 2, -20, -2, -5, -8, -15, -9, 5, 9, 13, 8,
+12, 12, -6, 10, 16, 13, 1, 13, 6, 7, 16, 15, 1, 15, 0, 5,
+22, 24, 7, 20, 5, 13, 9, 2, 11, 14, 22, 2, 6, -2, 3, 4,
+18, 20, 1, 7, 7, 5, 17, 16, -9, 0, 2, 4, 0, 7, -12, -4,
+5, -13, -14, -3, -16, -6, -18, -17, -14, -3, -8, -8, -8, -14, 0, -10,
+-9, -23, -18, -10, -1, -7, -23, -4, -18, -9, -18, -21, -3, -10, -6, -3,
+-5, -9, -10, -5, -11, -10, 4, -6, 4, 3, -1, 7, -2, -9, 11, 10,
+10, 15, 4, 5, 10, 16, 3, 15, 20, 4, -1, 3, 14, 4, 21, 2,
+20, 8, 21, 8, 2, 15, 6, 20, 17, 4, 9, 10, 15, 3, 9, 7,
+8, 7, 4, 2, 2, 14, 3, -7, -1, 6, 4, -10, -4, -3, 4, -9,
+5, 2, -16, -6, -6, -4, 1, -14, -2, -19, -2, -14, -19, -3, 0, -7,
+-4, -12, -15, -7, -4, -15, -12, -14, -14, -2, -19, -18, -14, -2, -6, -2,
+-2, 2, -3, -14, -12, -5, -10, -6, -6, 8, 9, 4, -1, 0, -6, 2,
+-4, 4, 10, 3, 9, 12, 14, 5, 2, 15, 8, 4, 12, 15, 18, 7,
+5, 5, 5, 4, 17, 12, 1, 1, 3, 17, 5, 14, 3, 2, 15, -1,
+6, 6, 3, 10, 11, -1, 0, 3, 2, 4, 6, -2, 8, -1, -9, -3,
+-1, -8, 4, -2, -3, -8, -11, -9, -3, -3, -3, -14, -2, -4, -4, -7,
+-2, 0, -7, -9, -7, -3, -5, -4, -11, -6, -12, -7, -15, -7, -4, 0,
+-7, 0, -11, -14, -5, -7, -6, -3, 0, 2, -6, -1, 0, 1, 0, -1,
+5, -7, 5, -4, -3, 5, 2, 1, -3, -3, 1, -2, 8, 1, 4, 5,
+9, 11, 8, 2, 1, 8, 5, 10, 3, 10, 5, 4, 3, 11, 7, 8,
+12, 0, 7, 4, 2, 10, 2, 4, 4, 0, 2, -3, 4, 5, 10, 9,
+0, 8, -4, -4, 1, 3, 1, -7, -2, -1, -3, 2, 1, -8, -3, -1,
+0, -2, 2, -1, -6, -1, -4, -4, -4, -3, -3, -7, -2, -7, -3, -1,
+-6, -11, -1, -10, -10, -12, -7, -7, -2, -10, -7, -2, -11, -6, -9, -1,
+-6, -8, -8, -7, 0, -7, -8, -5, -7, 1, 2, 0, -2, -5, 3, -2,
+2, 7, -1, 4, 1, 3, 2, 5, 4, -2, 7, 1, 2, 4, 6, 8,
+1, 4, 6, 5, 2, 9, 10, 7, 6, 2, 5, 8, 3, 5, 5, 3,
+6, 3, 9, 8, 2, 0, -1, 7, 3, -1, -2, 6, 0, 7, 1, 3,
+0, 3, -2, -1, -3, -4, 1, 5, -5, 3, -3, -5, -6, -3, -6, -2,
+-3, -6, 1, -2, -1, -6, -1, -2, -1, -7, 0, -5, -8, 0, -6, -1,
+-7, -8, -4, -4, -3, -3, -6, -2, -4, -7, -3, -5, -4, -7, -6, -6,
+-2, -7, -4, -4, 0, -6, -2, 0, -3, 2, -4, -1, -3, -3, -4, 2,
+1, 3, 0, -2, 2, 4, 1, -1, 2, 4, 4, 3, 4, -2, -1, -1,
+2, 3, -1, 6, 4, 5, 7, 5, 5, 5, 4, 6, 6, 2, 6, 1,
+4, 7, 2, 7, 4, 5, 1, 0, 2, 4, 6, 4, 3, 2, 3, 4,
+5, 1, 3, 1, 0, -1, 1, 2, 1, 1, 3, 0, 2, 1, 3, -1,
+0, 2, -2, 1, -2, -3, -1, -1, -3, -3, 2, -2, 0, -2, -2, -4,
+-4, 0, -1, -4, -3, -2, -5, -2, 0, -2, -3, -5, -3, -2, -2, -1,
+-4, -5, 0, -3, -1, -2, 0, -2, -1, -2, 0, -1, 0, -3, -4, -4,
+-2, -2, -1, -2, 1, -2, -4, -1, 0, -2, 0, -2, 2, -1, 2, 0,
+1, -1, 2, 3, -1, 1, -1, 3, 3, 3, 2, 1, 2, -1, 0, 2,
+3, 1, -1, 0, 1, 1, 4, 3, 4, 3, 3, 3, 1, 3, 3, 3,
+2, 2, 4, 4, 1, 4, 2, 0, 3, 4, 2, 2, 1, 1, 2, 2,
+2, 2, 0, 3, 1, 1, 0, 2, 2, 2, 2, 0, 1, 1, 0, -1,
+1, 2, 0, 2, -2, 0, -1, 0, -1, 0, -2, -1, -1, -1, -1, 1,
+-1, -1, -2, -1, 0, 0, 0, -1, -2, 0, 0, 0, -3, -1, -3, -2,
+-1, 0, -1, -2, -2, -2, -2, -3, 0, 0, -3, 0, -1, -1, -2, -1,
+0, -1, 0, -3, -2, -2, -2, 0, 0, 0, -1, 0, 0, -2, 0, 1,
+-2, -1, -1, 0, -1, -1, -1, 0, 0, -1, 1, -1, -1, 0, 1, 0,
+-1, -1, 1, 0, -1, 1, -1, 0, 1, 0, 0, 1, 0, 1, 0, 1,
+0, 1, 2, 2, 0, 2, 1, 1, 1, 0, 2, 1, 0, 2, 0, 1,
+0, 0, 2, 1, 1, 0, 1, 0, 2, 0, 2, 2, 0, 0, 0, 0,
+1, 1, 2, 1, 0, 1, 0, 0, 0, 1, 0, 1, 1, 1, 1, 0,
+1, 0, 0, 1, 0, 1, 0, 1, -1, 0, 0, 1, -1, 0, 0, -1,
+0, -1, 0, 0, 0, 0, 0, -1, -1, 0, 0, -1, -1, -1, 0, 0,
+0, 0, -1, 0, -1, 0, 0, 0, 0, 0, 0, 0, -1, -1, -1, -1,
+0, -1, -1, -1, 0, 0, -1, -1, 0, 0, -1, -1, -1, 0, 0, 0,
+-1, 0, 0, 0, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
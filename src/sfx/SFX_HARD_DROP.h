@@ -0,0 +1,2 @@
+#define SFX_HARD_DROP_LENGTH 2522
+extern const signed char SFX_HARD_DROP_data[2522];
@@ -0,0 +1,396 @@
+const signed char SFX_LINE_CLEAR_data[6304] = {
+0, 2, 4, 5, 7, 9, 11, 13, 14, 16, 18, 20, 22, 24, 25, 27,
+29, 31, 33, 34, 36, -38, -40, -42, -43, -45, -47, -49, -51, -53, -54, -56,
+-58, -60, -62, -63, -65, -67, -69, -71, -72, 74, 76, 76, 76, 76, 76, 76,
+76, 76, 75, 75, 75, 75, 75, 75, 75, 75, 75, 75, 74, -74, -74, -74,
+-74, -74, -74, -74, -74, -74, -73, -73, -73, -73, -73, -73, -73, -73, -73, -73,
+-72, 72, 72, 72, 72, 72, 72, 72, 72, 72, 72, 71, 71, 71, 71, 71,
+71, 71, 71, 71, 71, -70, -70, -70, -70, -70, -70, -70, -70, -70, -70, -70,
+-69, -69, -69, -69, -69, -69, -69, -69, -69, 69, 68, 68, 68, 68, 68, 68,
+68, 68, 68, 68, 68, 67, 67, 67, 67, 67, 67, 67, 67, -67, -67, -67,
+-66, -66, -66, -66, -66, -66, -66, -66, -66, -66, -65, -65, -65, -65, -65, -65,
+-65, 65, 65, 65, 65, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+63, 63, 63, 63, 63, -63, -63, -63, -63, -63, -63, -62, -62, -62, -62, -62,
+-62, -62, -62, -62, -62, -62, -62, -61, -61, 61, 61, 61, 61, 61, 61, 61,
+61, 61, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60, -59, -59, -59,
+-59, -59, -59, -59, -59, -59, -59, -59, -59, -58, -58, -58, -58, -58, -58, -58,
+-58, -58, 58, 58, 57, 57, 57, 57, 57, 57, 57, 57, 57, 57, 57, 57,
+56, 56, 56, 56, 56, 56, -56, -56, -56, -56, -56, -55, -55, -55, -55, -55,
+-55, -55, -55, -55, -55, -55, -55, -54, -54, -54, 54, 54, 54, 54, 54, 54,
+54, 54, 54, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, -53, -52,
+-52, -52, -52, -52, -52, -52, -52, -52, -52, -52, -52, -52, -51, -51, -51, -51,
+-51, -51, 51, 51, 51, 51, 51, 51, 50, 50, 50, 50, 50, 50, 50, 50,
+50, 50, 50, 50, 49, 49, -49, -49, -49, -49, -49, -49, -49, -49, -49, -49,
+-49, -48, -48, -48, -48, -48, -48, -48, -48, -48, 48, 48, 48, 48, 47, 47,
+47, 47, 47, 47, 47, 47, 47, 47, 47, 47, 46, 46, 46, 46, -46, -46,
+-46, -46, -46, -46, -46, -46, -46, -45, -45, -45, -45, -45, -45, -45, -45, -45,
+-45, -45, 45, 45, 44, 44, 44, 44, 44, 44, 44, 44, 44, 44, 44, 44,
+44, 44, 43, 43, 43, 43, -43, -43, -43, -43, -43, -43, -43, -43, -43, -42,
+-42, -42, -42, -42, -42, -42, -42, -42, -42, -42, 42, 42, 42, 41, 41, 41,
+41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 40, 40, 40, 40, 40, -40,
+-40, -40, -40, -40, -40, -40, -40, -40, -39, -39, -39, -39, -39, -39, -39, -39,
+-39, -39, -39, 39, 39, 39, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+38, 38, 38, 38, 38, 37, 37, -37, -37, -37, -37, -37, -37, -37, -37, -37,
+-37, -37, -37, -36, -36, -36, -36, -36, -36, -36, -36, 36, 36, 36, 36, 36,
+36, 36, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, -35,
+-35, -34, -34, -34, -34, -34, -34, -34, -34, -34, -34, -34, -34, -34, -34, -34,
+-33, -33, -33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 32,
+32, 32, 32, 32, 32, 32, 32, -32, -32, -32, -32, -32, -32, -32, -32, -31,
+-31, -31, -31, -31, -31, -31, -31, -31, -31, -31, -31, 31, 31, 31, 30, 30,
+30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 29, -29,
+-29, -29, -29, -29, -29, -29, -29, -29, -29, -29, -29, -29, -29, -29, -29, -28,
+-28, -28, -28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 27,
+27, 27, 27, 27, 27, 27, 27, -27, -27, -27, -27, -27, -27, -27, -27, -27,
+-26, -26, -26, -26, -26, -26, -26, -26, -26, -26, -26, -26, 26, 26, 26, 26,
+26, 25, 25, 25, 25, 25, 25, 25, 25, 25, 25, 25, 25, 25, 25, 25,
+-25, -25, -25, -24, -24, -24, -24, -24, -24, -24, -24, -24, -24, -24, -24, -24,
+-24, -24, -24, -24, 24, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,
+23, 23, 23, 23, 23, 23, 23, 22, -22, -22, -22, -22, -22, -22, -22, -22,
+-22, -22, -22, -22, -22, -22, -22, -22, -22, -22, -21, -21, 21, 21, 21, 21,
+21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 20, 20, 20,
+-20, -20, -20, -20, -20, -20, -20, -20, -20, -20, -20, -20, -20, -20, -20, -20,
+-20, -19, -19, -19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19,
+19, 19, 19, 19, 19, 18, 18, 18, -18, -18, -18, -18, -18, -18, -18, -18,
+-18, -18, -18, -18, -18, -18, -18, -18, -18, -18, -17, -17, 17, 17, 17, 17,
+17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 16,
+-16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16,
+-16, -16, -16, -16, 16, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+15, 15, 15, 15, 15, 15, 15, 15, 15, -15, -15, -15, -14, -14, -14, -14,
+-14, -14, -14, -14, -14, -14, -14, -14, -14, -14, -14, -14, -14, 14, 14, 14,
+14, 14, 14, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13,
+13, -13, -13, -13, -13, -13, -13, -13, -13, -13, -13, -13, -12, -12, -12, -12,
+-12, -12, -12, -12, -12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+12, 12, 12, 12, 12, 11, 11, 11, 11, -11, -11, -11, -11, -11, -11, -11,
+-11, -11, -11, -11, -11, -11, -11, -11, -11, -11, -11, -11, -11, 11, 11, 11,
+10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+10, -10, -10, -10, -10, -10, -10, -10, -10, -10, -10, -9, -9, -9, -9, -9,
+-9, -9, -9, -9, -9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+9, 9, 9, 9, 9, 9, 9, 9, 9, -8, -8, -8, -8, -8, -8, -8,
+-8, -8, -8, -8, -8, -8, -8, -8, -8, -8, -8, -8, -8, 8, 8, 8,
+8, 8, 8, 8, 8, 8, 8, 8, 7, 7, 7, 7, 7, 7, 7, 7,
+7, -7, -7, -7, -7, -7, -7, -7, -7, -7, -7, -7, -7, -7, -7, -7,
+-7, -7, -7, -7, -7, -7, 7, 7, 7, 6, 6, 6, 6, 6, 6, 6,
+6, 6, 6, 6, 6, 6, 6, 6, 6, 6, -6, -6, -6, -6, -6, -6,
+-6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -5, 5, 5,
+5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+5, 5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+-5, -5, -5, -5, -4, -4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+4, 4, 4, 4, 4, 4, 4, 4, 4, 4, -4, -4, -4, -4, -4, -4,
+-4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, 4, 4,
+3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+3, 3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+-3, -3, -3, -3, -3, -3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+3, 3, 3, 2, 2, 2, 2, 2, 2, 2, -2, -2, -2, -2, -2, -2,
+-2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, 2, 2,
+2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+2, 2, 2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+-2, -2, -1, -1, -1, -1, -1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1,
+1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+1, 1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, 1, 1, 1, 1, 1, 1, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 4, 5, 7, 9, 11, 13,
+14, 16, 18, 20, 22, 24, 25, 27, -29, -31, -33, -34, -36, -38, -40, -42,
+-43, -45, -47, -49, -51, -53, -54, -56, 58, 60, 62, 63, 65, 67, 69, 71,
+72, 74, 76, 76, 76, 76, 76, 76, -76, -76, -75, -75, -75, -75, -75, -75,
+-75, -75, -75, -75, -74, -74, -74, -74, 74, 74, 74, 74, 74, 74, 73, 73,
+73, 73, 73, 73, 73, 73, 73, 73, -72, -72, -72, -72, -72, -72, -72, -72,
+-72, -72, -72, -71, -71, -71, -71, -71, 71, 71, 71, 71, 71, 70, 70, 70,
+70, 70, 70, 70, 70, 70, 70, 70, -69, -69, -69, -69, -69, -69, -69, -69,
+-69, -69, -68, -68, -68, -68, -68, -68, 68, 68, 68, 68, 68, 67, 67, 67,
+67, 67, 67, 67, 67, 67, 67, 67, -66, -66, -66, -66, -66, -66, -66, -66,
+-66, -66, -65, -65, -65, -65, -65, -65, 65, 65, 65, 65, 65, 64, 64, 64,
+64, 64, 64, 64, 64, 64, 64, 64, -63, -63, -63, -63, -63, -63, -63, -63,
+-63, -63, -63, -62, -62, -62, -62, -62, 62, 62, 62, 62, 62, 62, 62, 61,
+61, 61, 61, 61, 61, 61, 61, 61, -61, -61, -60, -60, -60, -60, -60, -60,
+-60, -60, -60, -60, -60, -59, -59, -59, 59, 59, 59, 59, 59, 59, 59, 59,
+59, 58, 58, 58, 58, 58, 58, 58, -58, -58, -58, -58, -57, -57, -57, -57,
+-57, -57, -57, -57, -57, -57, -57, -57, 56, 56, 56, 56, 56, 56, 56, 56,
+56, 56, 56, 55, 55, 55, 55, 55, -55, -55, -55, -55, -55, -55, -55, -54,
+-54, -54, -54, -54, -54, -54, -54, -54, 54, 54, 54, 53, 53, 53, 53, 53,
+53, 53, 53, 53, 53, 53, 53, -52, -52, -52, -52, -52, -52, -52, -52, -52,
+-52, -52, -52, -52, -51, -51, -51, 51, 51, 51, 51, 51, 51, 51, 51, 51,
+50, 50, 50, 50, 50, 50, 50, -50, -50, -50, -50, -50, -49, -49, -49, -49,
+-49, -49, -49, -49, -49, -49, -49, 49, 49, 48, 48, 48, 48, 48, 48, 48,
+48, 48, 48, 48, 48, 48, 47, -47, -47, -47, -47, -47, -47, -47, -47, -47,
+-47, -47, -46, -46, -46, -46, -46, 46, 46, 46, 46, 46, 46, 46, 46, 45,
+45, 45, 45, 45, 45, 45, 45, -45, -45, -45, -45, -45, -44, -44, -44, -44,
+-44, -44, -44, -44, -44, -44, -44, 44, 44, 44, 43, 43, 43, 43, 43, 43,
+43, 43, 43, 43, 43, 43, 43, -42, -42, -42, -42, -42, -42, -42, -42, -42,
+-42, -42, -42, -42, -42, -41, -41, 41, 41, 41, 41, 41, 41, 41, 41, 41,
+41, 41, 40, 40, 40, 40, 40, -40, -40, -40, -40, -40, -40, -40, -40, -40,
+-39, -39, -39, -39, -39, -39, -39, 39, 39, 39, 39, 39, 39, 39, 38, 38,
+38, 38, 38, 38, 38, 38, 38, -38, -38, -38, -38, -38, -38, -37, -37, -37,
+-37, -37, -37, -37, -37, -37, -37, 37, 37, 37, 37, 36, 36, 36, 36, 36,
+36, 36, 36, 36, 36, 36, 36, -36, -36, -36, -35, -35, -35, -35, -35, -35,
+-35, -35, -35, -35, -35, -35, -35, 35, 35, 34, 34, 34, 34, 34, 34, 34,
+34, 34, 34, 34, 34, 34, 34, -34, -33, -33, -33, -33, -33, -33, -33, -33,
+-33, -33, -33, -33, -33, -33, -33, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+32, 32, 32, 32, 32, 32, -32, -31, -31, -31, -31, -31, -31, -31, -31, -31,
+-31, -31, -31, -31, -31, -31, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30,
+30, 30, 30, 30, 30, 30, -29, -29, -29, -29, -29, -29, -29, -29, -29, -29,
+-29, -29, -29, -29, -29, -29, 29, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+28, 28, 28, 28, 28, 28, -28, -27, -27, -27, -27, -27, -27, -27, -27, -27,
+-27, -27, -27, -27, -27, -27, 27, 27, 26, 26, 26, 26, 26, 26, 26, 26,
+26, 26, 26, 26, 26, 26, -26, -26, -26, -25, -25, -25, -25, -25, -25, -25,
+-25, -25, -25, -25, -25, -25, 25, 25, 25, 25, 25, 24, 24, 24, 24, 24,
+24, 24, 24, 24, 24, 24, -24, -24, -24, -24, -24, -24, -24, -23, -23, -23,
+-23, -23, -23, -23, -23, -23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 22,
+22, 22, 22, 22, 22, 22, -22, -22, -22, -22, -22, -22, -22, -22, -22, -22,
+-22, -22, -21, -21, -21, -21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+21, 21, 21, 21, 21, 20, -20, -20, -20, -20, -20, -20, -20, -20, -20, -20,
+-20, -20, -20, -20, -20, -20, 20, 20, 20, 19, 19, 19, 19, 19, 19, 19,
+19, 19, 19, 19, 19, 19, -19, -19, -19, -19, -19, -19, -19, -18, -18, -18,
+-18, -18, -18, -18, -18, -18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+18, 18, 17, 17, 17, 17, -17, -17, -17, -17, -17, -17, -17, -17, -17, -17,
+-17, -17, -17, -17, -17, -17, 17, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+16, 16, 16, 16, 16, -16, -16, -16, -16, -16, -16, -16, -16, -15, -15, -15,
+-15, -15, -15, -15, -15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+15, 15, 15, 15, 14, -14, -14, -14, -14, -14, -14, -14, -14, -14, -14, -14,
+-14, -14, -14, -14, -14, 14, 14, 14, 14, 14, 14, 13, 13, 13, 13, 13,
+13, 13, 13, 13, 13, -13, -13, -13, -13, -13, -13, -13, -13, -13, -13, -13,
+-13, -13, -13, -13, -12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+12, 12, 12, 12, 12, -12, -12, -12, -12, -12, -12, -12, -12, -11, -11, -11,
+-11, -11, -11, -11, -11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
+11, 11, 11, 11, 11, -11, -11, -11, -10, -10, -10, -10, -10, -10, -10, -10,
+-10, -10, -10, -10, -10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+10, 10, 10, 9, 9, -9, -9, -9, -9, -9, -9, -9, -9, -9, -9, -9,
+-9, -9, -9, -9, -9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+9, 8, 8, 8, 8, -8, -8, -8, -8, -8, -8, -8, -8, -8, -8, -8,
+-8, -8, -8, -8, -8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+7, 7, 7, 7, 7, -7, -7, -7, -7, -7, -7, -7, -7, -7, -7, -7,
+-7, -7, -7, -7, -7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+7, 6, 6, 6, 6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+-6, -6, -6, -6, -6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+6, 6, 6, 6, 6, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+-5, -5, -5, -5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+5, 5, 5, 5, -5, -5, -5, -5, -5, -5, -5, -5, -4, -4, -4, -4,
+-4, -4, -4, -4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+4, 4, 4, 4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+-4, -4, -4, -4, 4, 4, 4, 4, 3, 3, 3, 3, 3, 3, 3, 3,
+3, 3, 3, 3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+-3, -3, -3, -3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+3, 3, 3, 3, -3, -3, -3, -3, -3, -3, -3, -2, -2, -2, -2, -2,
+-2, -2, -2, -2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+2, 2, 2, 2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+-2, -2, -2, -2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+2, 2, 2, 2, -2, -2, -2, -2, -2, -2, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+1, 1, 1, 1, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 2, 4, 5, 7, 9, 11, 13, 14, 16, 18, 20, 22, 24, -25, -27,
+-29, -31, -33, -34, -36, -38, -40, -42, -43, -45, -47, 49, 51, 53, 54, 56,
+58, 60, 62, 63, 65, 67, 69, 71, 72, -74, -76, -76, -76, -76, -76, -76,
+-76, -76, -75, -75, -75, -75, 75, 75, 75, 75, 75, 75, 74, 74, 74, 74,
+74, 74, 74, 74, -74, -74, -73, -73, -73, -73, -73, -73, -73, -73, -73, -73,
+-72, 72, 72, 72, 72, 72, 72, 72, 72, 72, 72, 71, 71, 71, -71, -71,
+-71, -71, -71, -71, -71, -70, -70, -70, -70, -70, -70, -70, 70, 70, 70, 70,
+69, 69, 69, 69, 69, 69, 69, 69, 69, -69, -68, -68, -68, -68, -68, -68,
+-68, -68, -68, -68, -68, -67, -67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+66, 66, 66, 66, -66, -66, -66, -66, -66, -66, -65, -65, -65, -65, -65, -65,
+-65, 65, 65, 65, 65, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, -64,
+-63, -63, -63, -63, -63, -63, -63, -63, -63, -63, -63, -62, 62, 62, 62, 62,
+62, 62, 62, 62, 62, 62, 62, 61, 61, 61, -61, -61, -61, -61, -61, -61,
+-61, -61, -60, -60, -60, -60, -60, 60, 60, 60, 60, 60, 60, 59, 59, 59,
+59, 59, 59, 59, -59, -59, -59, -59, -59, -58, -58, -58, -58, -58, -58, -58,
+-58, -58, 58, 58, 57, 57, 57, 57, 57, 57, 57, 57, 57, 57, 57, -57,
+-56, -56, -56, -56, -56, -56, -56, -56, -56, -56, -56, -55, -55, 55, 55, 55,
+55, 55, 55, 55, 55, 55, 55, 54, 54, 54, -54, -54, -54, -54, -54, -54,
+-54, -54, -54, -53, -53, -53, -53, 53, 53, 53, 53, 53, 53, 53, 53, 52,
+52, 52, 52, 52, 52, -52, -52, -52, -52, -52, -52, -52, -51, -51, -51, -51,
+-51, -51, 51, 51, 51, 51, 51, 51, 50, 50, 50, 50, 50, 50, 50, 50,
+-50, -50, -50, -50, -49, -49, -49, -49, -49, -49, -49, -49, -49, 49, 49, 49,
+49, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, -48, -48, -48, -47, -47,
+-47, -47, -47, -47, -47, -47, -47, -47, 47, 47, 46, 46, 46, 46, 46, 46,
+46, 46, 46, 46, 46, -46, -46, -45, -45, -45, -45, -45, -45, -45, -45, -45,
+-45, -45, -45, 45, 44, 44, 44, 44, 44, 44, 44, 44, 44, 44, 44, 44,
+-44, -44, -43, -43, -43, -43, -43, -43, -43, -43, -43, -43, -43, -43, 43, 42,
+42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, -42, -42, -41, -41, -41,
+-41, -41, -41, -41, -41, -41, -41, -41, 41, 41, 40, 40, 40, 40, 40, 40,
+40, 40, 40, 40, 40, 40, -40, -40, -39, -39, -39, -39, -39, -39, -39, -39,
+-39, -39, -39, 39, 39, 39, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+38, -38, -38, -38, -38, -37, -37, -37, -37, -37, -37, -37, -37, -37, 37, 37,
+37, 37, 37, 36, 36, 36, 36, 36, 36, 36, 36, -36, -36, -36, -36, -36,
+-36, -36, -35, -35, -35, -35, -35, -35, -35, 35, 35, 35, 35, 35, 35, 35,
+35, 34, 34, 34, 34, 34, -34, -34, -34, -34, -34, -34, -34, -34, -34, -34,
+-33, -33, -33, -33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 32,
+32, -32, -32, -32, -32, -32, -32, -32, -32, -32, -32, -32, -32, -32, 32, 31,
+31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, -31, -31, -30, -30,
+-30, -30, -30, -30, -30, -30, -30, -30, -30, 30, 30, 30, 30, 30, 29, 29,
+29, 29, 29, 29, 29, 29, 29, -29, -29, -29, -29, -29, -29, -29, -29, -28,
+-28, -28, -28, -28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 27,
+27, 27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, 27,
+26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, -26, -26, -26, -26,
+-26, -25, -25, -25, -25, -25, -25, -25, -25, -25, 25, 25, 25, 25, 25, 25,
+25, 25, 25, 24, 24, 24, 24, -24, -24, -24, -24, -24, -24, -24, -24, -24,
+-24, -24, -24, -24, -24, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,
+23, 23, -23, -23, -23, -23, -23, -22, -22, -22, -22, -22, -22, -22, -22, 22,
+22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 21, 21, 21, -21, -21, -21,
+-21, -21, -21, -21, -21, -21, -21, -21, -21, -21, 21, 21, 21, 20, 20, 20,
+20, 20, 20, 20, 20, 20, 20, 20, -20, -20, -20, -20, -20, -20, -20, -20,
+-20, -19, -19, -19, -19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19,
+19, 19, -19, -19, -19, -18, -18, -18, -18, -18, -18, -18, -18, -18, -18, -18,
+18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 17, 17, 17, -17, -17, -17,
+-17, -17, -17, -17, -17, -17, -17, -17, -17, -17, -17, 17, 17, 17, 17, 16,
+16, 16, 16, 16, 16, 16, 16, 16, -16, -16, -16, -16, -16, -16, -16, -16,
+-16, -16, -16, -16, -16, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+15, 15, 15, -15, -15, -15, -15, -15, -15, -15, -15, -15, -14, -14, -14, -14,
+14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, -14, -14,
+-14, -14, -14, -13, -13, -13, -13, -13, -13, -13, -13, 13, 13, 13, 13, 13,
+13, 13, 13, 13, 13, 13, 13, 13, -13, -13, -13, -13, -12, -12, -12, -12,
+-12, -12, -12, -12, -12, -12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+12, 12, 12, -12, -12, -11, -11, -11, -11, -11, -11, -11, -11, -11, -11, -11,
+-11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, -11, -11,
+-10, -10, -10, -10, -10, -10, -10, -10, -10, -10, -10, -10, 10, 10, 10, 10,
+10, 10, 10, 10, 10, 10, 10, 10, 10, -10, -10, -9, -9, -9, -9, -9,
+-9, -9, -9, -9, -9, -9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+9, 9, 9, 9, -9, -9, -9, -9, -9, -8, -8, -8, -8, -8, -8, -8,
+-8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, -8,
+-8, -8, -8, -8, -8, -8, -8, -8, -7, -7, -7, -7, 7, 7, 7, 7,
+7, 7, 7, 7, 7, 7, 7, 7, 7, -7, -7, -7, -7, -7, -7, -7,
+-7, -7, -7, -7, -7, -7, -7, 7, 7, 6, 6, 6, 6, 6, 6, 6,
+6, 6, 6, 6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+-6, -6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 5, 5, -5,
+-5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, 5, 5, 5, 5,
+5, 5, 5, 5, 5, 5, 5, 5, 5, 5, -5, -5, -5, -5, -5, -5,
+-5, -5, -5, -5, -4, -4, -4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+4, 4, 4, 4, 4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+-4, -4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, -4,
+-3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, 3, 3, 3,
+3, 3, 3, 3, 3, 3, 3, 3, 3, 3, -3, -3, -3, -3, -3, -3,
+-3, -3, -3, -3, -3, -3, -3, -3, 3, 3, 3, 3, 3, 3, 3, 3,
+3, 3, 3, 2, 2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+-2, -2, -2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+-2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, 2, 2, 2,
+2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, -2, -2, -2, -2, -2,
+-2, -2, -1, -1, -1, -1, -1, -1, 1, 1, 1, 1, 1, 1, 1, 1,
+1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 1,
+1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 1, 1, 1, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 4, 5, 7, 9, 11, 13,
+14, 16, 18, -20, -22, -24, -25, -27, -29, -31, -33, -34, -36, 38, 40, 42,
+43, 45, 47, 49, 51, 53, 54, -56, -58, -60, -62, -63, -65, -67, -69, -71,
+-72, 74, 76, 76, 76, 76, 76, 76, 76, 76, 75, -75, -75, -75, -75, -75,
+-75, -75, -75, -75, -74, 74, 74, 74, 74, 74, 74, 74, 74, 74, 73, -73,
+-73, -73, -73, -73, -73, -73, -73, -73, -72, 72, 72, 72, 72, 72, 72, 72,
+72, 72, 72, -71, -71, -71, -71, -71, -71, -71, -71, -71, -71, 70, 70, 70,
+70, 70, 70, 70, 70, 70, 70, -70, -69, -69, -69, -69, -69, -69, -69, -69,
+-69, 69, 68, 68, 68, 68, 68, 68, 68, 68, 68, -68, -68, -67, -67, -67,
+-67, -67, -67, -67, -67, 67, 67, 67, 66, 66, 66, 66, 66, 66, 66, -66,
+-66, -66, -65, -65, -65, -65, -65, -65, -65, 65, 65, 65, 65, 64, 64, 64,
+64, 64, 64, -64, -64, -64, -64, -64, -63, -63, -63, -63, -63, 63, 63, 63,
+63, 63, 63, 62, 62, 62, 62, -62, -62, -62, -62, -62, -62, -62, -62, -61,
+-61, 61, 61, 61, 61, 61, 61, 61, 61, 61, 60, -60, -60, -60, -60, -60,
+-60, -60, -60, -60, -60, 59, 59, 59, 59, 59, 59, 59, 59, 59, 59, 59,
+-59, -58, -58, -58, -58, -58, -58, -58, -58, -58, 58, 58, 57, 57, 57, 57,
+57, 57, 57, 57, -57, -57, -57, -57, -56, -56, -56, -56, -56, -56, 56, 56,
+56, 56, 56, 55, 55, 55, 55, 55, -55, -55, -55, -55, -55, -55, -55, -54,
+-54, -54, 54, 54, 54, 54, 54, 54, 54, 54, 54, 53, -53, -53, -53, -53,
+-53, -53, -53, -53, -53, -53, 53, 52, 52, 52, 52, 52, 52, 52, 52, 52,
+-52, -52, -52, -52, -51, -51, -51, -51, -51, -51, 51, 51, 51, 51, 51, 51,
+50, 50, 50, 50, -50, -50, -50, -50, -50, -50, -50, -50, -49, -49, 49, 49,
+49, 49, 49, 49, 49, 49, 49, 49, -49, -48, -48, -48, -48, -48, -48, -48,
+-48, -48, 48, 48, 48, 48, 47, 47, 47, 47, 47, 47, -47, -47, -47, -47,
+-47, -47, -46, -46, -46, -46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 45,
+-45, -45, -45, -45, -45, -45, -45, -45, -45, -45, 45, 45, 44, 44, 44, 44,
+44, 44, 44, 44, -44, -44, -44, -44, -44, -44, -43, -43, -43, -43, 43, 43,
+43, 43, 43, 43, 43, 43, 43, 42, -42, -42, -42, -42, -42, -42, -42, -42,
+-42, -42, 42, 42, 42, 41, 41, 41, 41, 41, 41, 41, 41, -41, -41, -41,
+-41, -41, -40, -40, -40, -40, -40, 40, 40, 40, 40, 40, 40, 40, 40, 40,
+39, -39, -39, -39, -39, -39, -39, -39, -39, -39, -39, 39, 39, 39, 38, 38,
+38, 38, 38, 38, 38, -38, -38, -38, -38, -38, -38, -38, -38, -37, -37, 37,
+37, 37, 37, 37, 37, 37, 37, 37, 37, -37, -37, -36, -36, -36, -36, -36,
+-36, -36, -36, 36, 36, 36, 36, 36, 36, 36, 35, 35, 35, -35, -35, -35,
+-35, -35, -35, -35, -35, -35, -35, 35, 35, 34, 34, 34, 34, 34, 34, 34,
+34, -34, -34, -34, -34, -34, -34, -34, -33, -33, -33, 33, 33, 33, 33, 33,
+33, 33, 33, 33, 33, -33, -33, -32, -32, -32, -32, -32, -32, -32, -32, 32,
+32, 32, 32, 32, 32, 32, 32, 31, 31, -31, -31, -31, -31, -31, -31, -31,
+-31, -31, -31, 31, 31, 31, 30, 30, 30, 30, 30, 30, 30, -30, -30, -30,
+-30, -30, -30, -30, -30, -30, -29, 29, 29, 29, 29, 29, 29, 29, 29, 29,
+29, -29, -29, -29, -29, -29, -29, -28, -28, -28, -28, 28, 28, 28, 28, 28,
+28, 28, 28, 28, 28, -28, -28, -27, -27, -27, -27, -27, -27, -27, -27, 27,
+27, 27, 27, 27, 27, 27, 27, 27, 26, 26, -26, -26, -26, -26, -26, -26,
+-26, -26, -26, -26, 26, 26, 26, 26, 26, 25, 25, 25, 25, 25, -25, -25,
+-25, -25, -25, -25, -25, -25, -25, -25, 25, 25, 25, 24, 24, 24, 24, 24,
+24, 24, -24, -24, -24, -24, -24, -24, -24, -24, -24, -24, 24, 23, 23, 23,
+23, 23, 23, 23, 23, 23, -23, -23, -23, -23, -23, -23, -23, -23, -23, -22,
+22, 22, 22, 22, 22, 22, 22, 22, 22, 22, -22, -22, -22, -22, -22, -22,
+-22, -22, -21, -21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, -21, -21,
+-21, -21, -21, -21, -21, -20, -20, -20, 20, 20, 20, 20, 20, 20, 20, 20,
+20, 20, -20, -20, -20, -20, -20, -20, -20, -19, -19, -19, 19, 19, 19, 19,
+19, 19, 19, 19, 19, 19, -19, -19, -19, -19, -19, -19, -19, -18, -18, -18,
+18, 18, 18, 18, 18, 18, 18, 18, 18, 18, -18, -18, -18, -18, -18, -18,
+-18, -18, -17, -17, 17, 17, 17, 17, 17, 17, 17, 17, 17, 17, -17, -17,
+-17, -17, -17, -17, -17, -17, -17, -16, 16, 16, 16, 16, 16, 16, 16, 16,
+16, 16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, 16, 15, 15, 15,
+15, 15, 15, 15, 15, 15, 15, -15, -15, -15, -15, -15, -15, -15, -15, -15,
+-15, 15, 15, 15, 14, 14, 14, 14, 14, 14, 14, -14, -14, -14, -14, -14,
+-14, -14, -14, -14, -14, 14, 14, 14, 14, 14, 14, 13, 13, 13, 13, -13,
+-13, -13, -13, -13, -13, -13, -13, -13, -13, 13, 13, 13, 13, 13, 13, 13,
+13, 13, 13, -13, -12, -12, -12, -12, -12, -12, -12, -12, -12, 12, 12, 12,
+12, 12, 12, 12, 12, 12, 12, -12, -12, -12, -12, -12, -12, -11, -11, -11,
+-11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, -11, -11, -11, -11, -11,
+-11, -11, -11, -11, -11, 11, 11, 11, 10, 10, 10, 10, 10, 10, 10, -10,
+-10, -10, -10, -10, -10, -10, -10, -10, -10, 10, 10, 10, 10, 10, 10, 10,
+10, 10, 10, -9, -9, -9, -9, -9, -9, -9, -9, -9, -9, 9, 9, 9,
+9, 9, 9, 9, 9, 9, 9, -9, -9, -9, -9, -9, -9, -9, -9, -9,
+-9, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, -8, -8, -8, -8, -8,
+-8, -8, -8, -8, -8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, -8,
+-7, -7, -7, -7, -7, -7, -7, -7, -7, 7, 7, 7, 7, 7, 7, 7,
+7, 7, 7, -7, -7, -7, -7, -7, -7, -7, -7, -7, -7, -7, 7, 7,
+7, 6, 6, 6, 6, 6, 6, 6, -6, -6, -6, -6, -6, -6, -6, -6,
+-6, -6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, -6, -6, -6, -6,
+-6, -6, -6, -6, -6, -5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+-5, -5, -5, -5, -5, -5, -5, -5, -5, -5, 5, 5, 5, 5, 5, 5,
+5, 5, 5, 5, -5, -5, -5, -5, -5, -5, -5, -5, -4, -4, 4, 4,
+4, 4, 4, 4, 4, 4, 4, 4, -4, -4, -4, -4, -4, -4, -4, -4,
+-4, -4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, -4, -4, -4, -4,
+-4, -4, -4, -4, -4, -4, 4, 4, 3, 3, 3, 3, 3, 3, 3, 3,
+-3, -3, -3, -3, -3, -3, -3, -3, -3, -3, 3, 3, 3, 3, 3, 3,
+3, 3, 3, 3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, 3, 3,
+3, 3, 3, 3, 3, 3, 3, 3, -3, -3, -3, -2, -2, -2, -2, -2,
+-2, -2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, -2, -2, -2, -2,
+-2, -2, -2, -2, -2, -2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+-2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, 2, 2, 2, 2, 2,
+2, 2, 2, 2, 2, -2, -2, -2, -2, -2, -1, -1, -1, -1, -1, 1,
+1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 1, 1, 1, 1,
+1, 1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1,
+1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
@@ -0,0 +1,2 @@
+#define SFX_LINE_CLEAR_LENGTH 6304
+extern const signed char SFX_LINE_CLEAR_data[6304];
@@ -0,0 +1,81 @@
+const signed char SFX_LOCK_data[1261] = {
+0, 0, 0, 0, 0, 1, 2, 3, -1, -1, 5, 3, 6, 0, 5, 8,
+4, 13, 14, 3, 3, 12, 19, 11, 9, 14, 8, 12, 18, 20, 15, 16,
+17, 24, 21, 15, 37, 31, 34, 23, 47, 45, 23, 31, 44, 45, 53, 37,
+52, 47, 35, 46, 58, 57, 45, 49, 27, 35, 59, 43, 32, 49, 56, 55,
+41, 44, 47, 59, 46, 39, 44, 19, 19, 52, 67, 45, 33, 19, 36, 62,
+49, 34, 51, 12, 27, 52, 27, 18, 4, 19, 44, -21, 28, 28, 30, 18,
+20, -3, -2, -15, -44, 12, -13, -43, -24, -28, -41, -44, -32, -28, -32, -46,
+-81, -68, -74, -46, -27, -34, -36, -37, -81, -39, -53, -98, -105, -106, -53, -92,
+-103, -67, -88, -109, -104, -78, -105, -98, -66, -86, -95, -85, -117, -91, -89, -105,
+-111, -54, -82, -103, -74, -59, -114, -113, -103, -62, -100, -61, -62, -70, -91, -37,
+-48, -66, -85, -54, -70, -55, -71, -48, -85, -66, -19, -23, -60, -20, -55, -10,
+-21, -41, -49, -63, -3, -56, -2, 10, -13, -37, 11, 21, 6, -5, -11, -10,
+-17, 16, 3, -10, -14, 25, 4, 19, 10, 48, 52, -2, 11, 22, 66, 55,
+29, 23, 54, 66, 74, 38, 74, 63, 52, 85, 39, 71, 33, 39, 86, 44,
+79, 70, 86, 58, 57, 54, 90, 75, 96, 92, 47, 73, 46, 42, 44, 91,
+86, 89, 59, 75, 84, 60, 71, 50, 41, 51, 86, 66, 86, 58, 46, 75,
+76, 28, 64, 29, 29, 72, 22, 32, 73, 39, 20, 21, 23, 50, 12, 55,
+23, 54, 49, 13, 9, 19, -4, 24, -11, -15, 36, -3, 11, 1, -9, -24,
+20, 21, 18, -30, -26, -7, 11, -14, -9, -12, -35, -22, -36, -41, -51, -43,
+-8, -37, -28, -30, -16, -46, -52, -52, -54, -28, -27, -58, -57, -48, -47, -47,
+-65, -77, -67, -76, -52, -77, -77, -50, -67, -42, -57, -39, -74, -57, -43, -78,
+-35, -73, -43, -32, -40, -64, -73, -53, -33, -62, -33, -68, -31, -71, -57, -28,
+-32, -26, -28, -31, -33, -55, -42, -53, -26, -27, -45, -52, -9, -15, -25, -24,
+-8, -24, -25, -26, -28, -37, -7, -16, -7, -28, -14, -22, -20, -13, 14, -3,
+-1, 10, -5, -14, 11, 11, 19, 12, 24, 27, 8, 20, 21, 11, 21, 28,
+44, 46, 20, 37, 13, 15, 35, 51, 22, 48, 54, 31, 48, 55, 36, 50,
+52, 47, 58, 60, 63, 48, 32, 36, 34, 49, 56, 28, 53, 55, 40, 46,
+33, 54, 27, 64, 56, 49, 35, 59, 60, 28, 52, 54, 46, 47, 36, 53,
+54, 31, 46, 31, 20, 25, 17, 45, 45, 13, 30, 21, 10, 15, 12, 29,
+1, 6, 14, -3, 18, 16, 23, -1, 0, 8, -3, 7, -6, 8, 10, 9,
+14, -3, -6, 5, 1, -7, -15, -19, -26, -4, -28, -8, -16, -3, -11, -5,
+-34, -23, -21, -31, -26, -31, -26, -45, -31, -31, -37, -34, -22, -26, -33, -28,
+-38, -44, -50, -42, -32, -23, -25, -35, -21, -37, -26, -39, -29, -21, -42, -46,
+-32, -35, -39, -50, -38, -36, -37, -23, -30, -25, -20, -24, -31, -23, -25, -24,
+-24, -30, -23, -22, -12, -16, -13, -15, -13, -18, -24, -26, -12, -6, -15, -25,
+-5, -13, -13, -23, -10, -2, -10, -11, -1, -18, -3, 10, 4, -3, 6, 4,
+-5, -4, 15, 0, -5, 16, 9, 6, 11, 18, 4, 17, 19, 23, 10, 19,
+10, 19, 10, 27, 29, 16, 14, 33, 27, 31, 12, 34, 27, 20, 23, 32,
+33, 19, 29, 19, 38, 26, 37, 33, 30, 22, 28, 19, 19, 32, 24, 33,
+21, 32, 32, 22, 17, 23, 25, 16, 18, 14, 26, 32, 17, 12, 27, 28,
+31, 23, 16, 27, 10, 22, 9, 14, 16, 13, 7, 8, 20, 12, 13, 5,
+15, 6, 10, 16, 17, -3, 12, 12, 0, 1, 4, 10, -1, 8, 4, -8,
+6, -13, -11, -1, -14, -8, -14, -8, -1, -1, -18, -18, -4, -20, -16, -19,
+-20, -22, -11, -10, -11, -9, -13, -18, -14, -8, -15, -22, -26, -10, -17, -21,
+-17, -18, -19, -27, -22, -21, -25, -13, -21, -17, -16, -16, -16, -15, -24, -12,
+-25, -12, -13, -13, -26, -25, -13, -18, -20, -10, -24, -16, -17, -22, -17, -12,
+-9, -22, -14, -20, -8, -19, -19, -13, -8, -13, -16, -5, -4, -3, -11, -9,
+-11, -6, -8, -8, -1, 2, -2, -9, 0, -3, 6, 2, 4, 3, 1, 7,
+6, -1, -2, 2, 4, -1, 3, 6, 0, 10, 9, 5, 5, 6, 6, 12,
+9, 10, 5, 15, 8, 9, 6, 17, 11, 17, 17, 18, 16, 18, 18, 17,
+9, 13, 14, 19, 17, 16, 16, 12, 19, 15, 12, 13, 19, 14, 10, 9,
+15, 14, 17, 9, 12, 15, 7, 8, 12, 9, 7, 9, 12, 11, 6, 6,
+13, 11, 6, 13, 4, 7, 11, 10, 5, 11, 8, 10, 10, 5, 7, 5,
+9, 7, 6, 6, 8, 0, -1, 4, 4, 1, 1, -1, 4, 2, 0, -5,
+2, -2, -5, -4, -1, -7, -7, -5, -1, -2, 0, -4, -4, -5, -5, -5,
+-3, -2, -7, -5, -8, -8, -7, -7, -7, -4, -10, -7, -4, -6, -8, -9,
+-9, -5, -5, -7, -5, -5, -6, -9, -9, -6, -9, -7, -8, -9, -9, -11,
+-9, -9, -11, -10, -9, -5, -7, -9, -4, -9, -7, -5, -5, -7, -4, -6,
+-4, -6, -3, -4, -8, -7, -2, -6, -7, -6, -4, -1, -4, -2, -1, -5,
+-2, 1, -2, -2, -2, 1, 1, -3, 0, -1, 1, -2, -1, -1, 0, 2,
+3, 3, 2, -1, 1, 3, 1, 2, 4, 1, 4, 1, 2, 5, 2, 3,
+3, 5, 6, 3, 4, 6, 4, 3, 5, 3, 4, 2, 6, 5, 6, 6,
+4, 5, 4, 6, 6, 3, 4, 5, 4, 3, 3, 5, 5, 6, 4, 5,
+3, 4, 3, 5, 3, 3, 3, 4, 3, 4, 2, 5, 4, 3, 2, 2,
+4, 3, 4, 4, 2, 2, 2, 1, 1, 1, 1, 2, 2, 2, 2, 1,
+0, 1, 2, 1, -1, -1, 0, 1, -1, 0, 1, 1, 0, 0, 0, -2,
+-1, -1, -1, 0, 0, -2, -2, 0, -2, -2, -2, -2, -2, -2, -2, -1,
+-1, -2, -1, -2, -2, -2, -1, -2, -1, -2, -1, -2, -1, -2, -2, -2,
+-2, -2, -2, -2, -1, -2, -2, -3, -2, -2, -2, -2, -2, -2, -2, -2,
+-2, -2, -2, -2, -1, -1, -1, -1, -1, -1, -2, -1, -1, -2, -1, -1,
+-1, -1, -1, -1, -1, 0, -1, 0, -1, -1, -1, 0, -1, 0, 0, 0,
+-1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 1, 0, 1,
+0, 0, 0, 0, 1, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
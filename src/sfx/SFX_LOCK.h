@@ -0,0 +1,2 @@
+#define SFX_LOCK_LENGTH 1261
+extern const signed char SFX_LOCK_data[1261];
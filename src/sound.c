@@ -0,0 +1,91 @@
+#include "gbalib.h"
+#include "sound.h"
+#include "psg.h"
+#ifdef PCM_SOUND_EFFECTS
+#include "mixer.h"
+#include "sfx/SFX_LOCK.h"
+#include "sfx/SFX_HARD_DROP.h"
+#include "sfx/SFX_LINE_CLEAR.h"
+#include "sfx/SFX_GAME_OVER.h"
+#endif
+
+// Sound effects are played on the tone and noise channels by default, which
+// costs a few register writes per frame. Building with SOUND_EFFECTS=pcm
+// plays the sampled versions through the mixer instead, where there is one.
+
+#if defined(PCM_SOUND_EFFECTS) && defined(MUSIC_MAXMOD)
+#error "The sound effect mixer only runs alongside the streamed music"
+#endif
+
+static const PSG_STEP lockSteps[] = {
+    {4, 0, PSG_ENV(6, 1), PSG_NOISE(6, 4)},
+    {0, 0, 0, 0}
+};
+
+static const PSG_STEP hardDropSquare[] = {
+    {8, PSG_SWEEP(2, 2) | PSG_SWEEP_DOWN, PSG_ENV(12, 2) | PSG_DUTY_50,
+        PSG_RATE(392)},
+    {0, 0, 0, 0}
+};
+
+static const PSG_STEP hardDropNoise[] = {
+    {6, 0, PSG_ENV(10, 1), PSG_NOISE(4, 3)},
+    {0, 0, 0, 0}
+};
+
+static const PSG_STEP rotateSteps[] = {
+    {4, 0, PSG_ENV(8, 1) | PSG_DUTY_25, PSG_RATE(1047)},
+    {0, 0, 0, 0}
+};
+
+static const PSG_STEP lineClearSteps[] = {
+    {4, 0, PSG_ENV(10, 0) | PSG_DUTY_50, PSG_RATE(523)},
+    {4, 0, PSG_ENV(10, 0) | PSG_DUTY_50, PSG_RATE(659)},
+    {4, 0, PSG_ENV(10, 0) | PSG_DUTY_50, PSG_RATE(784)},
+    {4, 0, PSG_ENV(10, 3) | PSG_DUTY_50, PSG_RATE(1047)},
+    {0, 0, 0, 0}
+};
+
+static const PSG_STEP gameOverSteps[] = {
+    {10, 0, PSG_ENV(12, 0) | PSG_DUTY_50, PSG_RATE(440)},
+    {10, 0, PSG_ENV(12, 0) | PSG_DUTY_50, PSG_RATE(349)},
+    {10, 0, PSG_ENV(12, 0) | PSG_DUTY_50, PSG_RATE(294)},
+    {10, PSG_SWEEP(7, 1) | PSG_SWEEP_DOWN, PSG_ENV(12, 7) | PSG_DUTY_50,
+        PSG_RATE(220)},
+    {0, 0, 0, 0}
+};
+
+// Indexed by SOUND_EFFECT
+static const PSG_PATCH patches[] = {
+    {0, 0, lockSteps},
+    {hardDropSquare, 0, hardDropNoise},
+    {0, rotateSteps, 0},
+    {lineClearSteps, 0, 0},
+    {gameOverSteps, 0, 0}
+};
+
+#ifdef PCM_SOUND_EFFECTS
+typedef struct {
+    const signed char *data;
+    int length;
+} SAMPLE;
+
+// Indexed by SOUND_EFFECT. Effects without a sample fall back to the PSG.
+static const SAMPLE samples[] = {
+    {SFX_LOCK_data, SFX_LOCK_LENGTH},
+    {SFX_HARD_DROP_data, SFX_HARD_DROP_LENGTH},
+    {0, 0},
+    {SFX_LINE_CLEAR_data, SFX_LINE_CLEAR_LENGTH},
+    {SFX_GAME_OVER_data, SFX_GAME_OVER_LENGTH}
+};
+#endif
+
+void playSoundEffect(enum SOUND_EFFECT effect) {
+#ifdef PCM_SOUND_EFFECTS
+    if (samples[effect].data) {
+        playSample(samples[effect].data, samples[effect].length);
+        return;
+    }
+#endif
+    playPsgPatch(&patches[effect]);
+}
@@ -0,0 +1,9 @@
+enum SOUND_EFFECT {
+    SOUND_LOCK,
+    SOUND_HARD_DROP,
+    SOUND_ROTATE,
+    SOUND_LINE_CLEAR,
+    SOUND_GAME_OVER
+};
+
+void playSoundEffect(enum SOUND_EFFECT effect);
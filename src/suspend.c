@@ -0,0 +1,67 @@
+#include <stddef.h>
+
+#include "gbalib.h"
+#include "main.h"
+#include "gameboard.h"
+#include "pentomino.h"
+#include "dashboard.h"
+#include "place.h"
+#include "save.h"
+#include "suspend.h"
+
+// Only needed while suspending or resuming, so it's kept out of IWRAM
+static SUSPEND_RECORD suspended EWRAM_BSS;
+
+static bool _readSuspended();
+
+// Saves the game in progress
+void suspendGame() {
+    suspended.magic = SUSPEND_MAGIC;
+    suspended.version = SUSPEND_VERSION;
+    saveBoard(suspended.board);
+    savePlacer(&suspended.placer);
+    saveDash(&suspended.dash);
+    suspended.linesCleared = getLinesCleared();
+    suspended.checksum = checksumSave(&suspended, sizeof(SUSPEND_RECORD),
+            offsetof(SUSPEND_RECORD, checksum));
+    
+    writeSram(SUSPEND_OFFSET, &suspended, sizeof(SUSPEND_RECORD));
+}
+
+// Whether there's a suspended game to resume
+bool hasSuspendedGame() {
+    return _readSuspended();
+}
+
+// Loads the suspended game back in, once the game's background has been drawn.
+// A suspended game can only be resumed once, so it's erased from SRAM.
+// Returns FALSE if there wasn't one.
+bool resumeGame() {
+    if (!_readSuspended()) {
+        return FALSE;
+    }
+    
+    unsigned int erased = 0;
+    writeSram(SUSPEND_OFFSET, &erased, sizeof(erased));
+    
+    loadBoard(suspended.board);
+    loadPlacer(&suspended.placer);
+    loadDash(&suspended.dash);
+    setLinesCleared(suspended.linesCleared);
+    
+    // A game suspended while cleared rows flashed was waiting on its next
+    // piece, and the rows are already down on the board
+    if (!isPlacing()) {
+        popPiece();
+    }
+    return TRUE;
+}
+
+static bool _readSuspended() {
+    readSram(SUSPEND_OFFSET, &suspended, sizeof(SUSPEND_RECORD));
+    return suspended.magic == SUSPEND_MAGIC
+            && suspended.version == SUSPEND_VERSION
+            && suspended.checksum == checksumSave(
+                    &suspended, sizeof(SUSPEND_RECORD),
+                    offsetof(SUSPEND_RECORD, checksum));
+}
@@ -0,0 +1,21 @@
+// A game in progress can be suspended to SRAM and picked up again later, even
+// after the power has been off. Only the game's state is saved, not the
+// screen, so the record is small enough to write all at once, and resuming
+// redraws everything the way a new game would.
+#define SUSPEND_OFFSET (2 * SAVE_SLOT_SIZE) // after the high score slots
+#define SUSPEND_MAGIC 0x50535553 // "SUSP"
+#define SUSPEND_VERSION 2
+
+typedef struct {
+    unsigned int magic;
+    unsigned short version;
+    unsigned short checksum;
+    unsigned char board[BOARD_HEIGHT][BOARD_WIDTH];
+    PLACER_STATE placer;
+    DASH_STATE dash;
+    int linesCleared;
+} SUSPEND_RECORD;
+
+void suspendGame();
+bool hasSuspendedGame();
+bool resumeGame();
@@ -0,0 +1,72 @@
+#include "gbalib.h"
+#include "clock.h"
+#include "trace.h"
+#include "debug.h"
+
+// Writing out events is slow, so only a few are written per frame. A long
+// session still leaves its last TRACE_SIZE events in memory for a debugger.
+#define TRACE_DRAIN_PER_FRAME 4
+
+static const char *eventNames[TRACE_EVENTS] = {
+    "spawn",
+    "lock",
+    "clear",
+    "state",
+    "overrun",
+    "loop",
+    "dropped"
+};
+
+static TRACE_RECORD records[TRACE_SIZE] EWRAM_BSS;
+// Counts of events recorded and written out so far. Both only ever go up, and
+// wrap around the ring buffer with TRACE_SIZE - 1.
+static unsigned int recorded;
+static unsigned int drained;
+
+void initTrace() {
+    recorded = 0;
+    drained = 0;
+}
+
+// Records an event. Events come from interrupts as well as the game loop, so
+// interrupts are held off while a record is half written, and then left the
+// way the caller had them.
+void traceEvent(enum TRACE_EVENT event, int arg) {
+    unsigned int time = getCycles();
+    unsigned short ime = REG_IME;
+    
+    REG_IME = 0;
+    TRACE_RECORD *record = &records[recorded & (TRACE_SIZE - 1)];
+    record->time = time;
+    record->event = event;
+    record->arg = arg;
+    recorded++;
+    REG_IME = ime;
+}
+
+// Writes some of the events that haven't been written yet to the debug log,
+// one per line, as "time event arg" in hex. Called once per frame.
+void drainTrace() {
+    if (!hasDebugLog()) {
+        return;
+    }
+    
+    // If the game got too far ahead, the oldest events have been overwritten
+    if (recorded - drained > TRACE_SIZE) {
+        drained = recorded - TRACE_SIZE;
+    }
+    
+    for (int i = 0; i < TRACE_DRAIN_PER_FRAME && drained != recorded; i++) {
+        TRACE_RECORD record = records[drained & (TRACE_SIZE - 1)];
+        volatile char *out = DEBUG_LOG_BUFFER;
+        
+        out += writeDebugHex(out, record.time, 8);
+        *out++ = ' ';
+        out += writeDebugString(out, eventNames[record.event]);
+        *out++ = ' ';
+        out += writeDebugHex(out, record.arg, 4);
+        *out = '\0';
+        sendDebugLog();
+        drained++;
+    }
+}
@@ -0,0 +1,38 @@
+// Event tracing (make TRACE=1). Game events are recorded with a timestamp
+// into a ring buffer in EWRAM, and slowly written out to the debug log of
+// emulators that have mGBA's debug registers. In normal builds the TRACE
+// macros compile to nothing.
+
+// Holds this many of the most recent events. Must be a power of two.
+#define TRACE_SIZE 1024
+
+enum TRACE_EVENT {
+    TRACE_SPAWN,      // a piece was popped from the queue (arg: the tile)
+    TRACE_LOCK,       // a piece was locked onto the board (arg: the tile)
+    TRACE_LINE_CLEAR, // rows were cleared (arg: how many)
+    TRACE_STATE,      // the game changed state (arg: the new state)
+    TRACE_OVERRUN,    // a frame ran long (arg: how many draws were skipped)
+    TRACE_AUDIO_LOOP, // the music looped back to its start
+    TRACE_DROPPED,    // the game fell too far behind (arg: ticks dropped)
+    TRACE_EVENTS
+};
+
+typedef struct {
+    unsigned int time; // getCycles() when the event happened
+    unsigned char event;
+    unsigned short arg;
+} TRACE_RECORD;
+
+#ifdef TRACE
+#define TRACE_EVENT(event, arg) traceEvent(event, arg)
+#define TRACE_INIT() initTrace()
+#define TRACE_DRAIN() drainTrace()
+#else
+#define TRACE_EVENT(event, arg)
+#define TRACE_INIT()
+#define TRACE_DRAIN()
+#endif
+
+void initTrace();
+void traceEvent(enum TRACE_EVENT event, int arg);
+void drainTrace();
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Writes Korobeiniki as a 4 channel ProTracker module for maxmod.
+
+Usage: mkmod.py [output.mod]
+
+The tune is short and public domain, so it's written out here note by note
+rather than kept as a binary in some tracker's project format. The module
+has a square wave lead, a triangle bass and a noise hat, and its order list
+plays part A twice, then part B. src/music.c relies on part B starting at
+order PART_B_ORDER.
+"""
+
+import math
+import random
+import struct
+import sys
+
+ROWS_PER_EIGHTH = 2
+ROWS = 64
+BPM = 150
+
+# ProTracker periods (finetune 0) for octaves 1 to 3
+PERIODS = [
+    856, 808, 762, 720, 678, 640, 604, 570, 538, 508, 480, 453,
+    428, 404, 381, 360, 339, 320, 302, 285, 269, 254, 240, 226,
+    214, 202, 190, 180, 170, 160, 151, 143, 135, 127, 120, 113,
+]
+NAMES = ['C', 'C#', 'D', 'D#', 'E', 'F', 'F#', 'G', 'G#', 'A', 'A#', 'B']
+
+LEAD, BASS, HAT = 1, 2, 3
+
+# A 32 byte loop plays C-2 as middle C, so octave 4 notes map to octave 2.
+# The bass loop is twice as long, so it sounds an octave lower again.
+LEAD_OCTAVE_SHIFT = 2
+BASS_OCTAVE_SHIFT = 1
+
+# (note, eighths), None is a rest
+PART_A = [
+    ('E5', 2), ('B4', 1), ('C5', 1), ('D5', 2), ('C5', 1), ('B4', 1),
+    ('A4', 2), ('A4', 1), ('C5', 1), ('E5', 2), ('D5', 1), ('C5', 1),
+    ('B4', 3), ('C5', 1), ('D5', 2), ('E5', 2),
+    ('C5', 2), ('A4', 2), ('A4', 2), (None, 2),
+    (None, 1), ('D5', 2), ('F5', 1), ('A5', 2), ('G5', 1), ('F5', 1),
+    ('E5', 3), ('C5', 1), ('E5', 2), ('D5', 1), ('C5', 1),
+    ('B4', 2), ('B4', 1), ('C5', 1), ('D5', 2), ('E5', 2),
+    ('C5', 2), ('A4', 2), ('A4', 2), (None, 2),
+]
+PART_A_BASS = ['E', 'A', 'E', 'A', 'D', 'C', 'E', 'A']
+
+PART_B = [
+    ('E5', 4), ('C5', 4),
+    ('D5', 4), ('B4', 4),
+    ('C5', 4), ('A4', 4),
+    ('G#4', 4), ('B4', 4),
+    ('E5', 4), ('C5', 4),
+    ('D5', 4), ('B4', 4),
+    ('C5', 2), ('E5', 2), ('A5', 4),
+    ('G#5', 8),
+]
+PART_B_BASS = ['A', 'E', 'A', 'E', 'A', 'E', 'A', 'E']
+
+
+def period(name, shift):
+    note, octave = name[:-1], int(name[-1]) - shift
+    return PERIODS[(octave - 1) * 12 + NAMES.index(note)]
+
+
+def cell(sample=0, per=0, effect=0, param=0):
+    return bytes([
+        (sample & 0xF0) | (per >> 8),
+        per & 0xFF,
+        ((sample & 0x0F) << 4) | effect,
+        param,
+    ])
+
+
+def empty_pattern():
+    return [[cell() for _ in range(4)] for _ in range(ROWS)]
+
+
+def write_melody(patterns, notes):
+    row = 0
+    for note, eighths in notes:
+        pattern, r = divmod(row, ROWS)
+        if note:
+            patterns[pattern][r][0] = cell(LEAD, period(note, LEAD_OCTAVE_SHIFT))
+        else:
+            # Volume 0 ends the previous note
+            patterns[pattern][r][0] = cell(effect=0xC, param=0)
+        row += eighths * ROWS_PER_EIGHTH
+
+
+def write_bass(patterns, roots):
+    for bar, root in enumerate(roots):
+        for eighth in range(8):
+            row = (bar * 8 + eighth) * ROWS_PER_EIGHTH
+            pattern, r = divmod(row, ROWS)
+            octave = 2 if eighth % 2 == 0 else 3
+            per = period('%s%d' % (root, octave), BASS_OCTAVE_SHIFT)
+            patterns[pattern][r][1] = cell(BASS, per)
+
+
+def write_hats(patterns):
+    for pattern in patterns:
+        for r in range(0, ROWS, 2 * ROWS_PER_EIGHTH):
+            pattern[r][2] = cell(HAT, period('C5', LEAD_OCTAVE_SHIFT))
+        pattern[0][3] = cell(effect=0xF, param=BPM)
+
+
+def samples():
+    lead = bytes((64 if i < 16 else -64) & 0xFF for i in range(32))
+    bass = bytes(int(round(96 * (1 - abs(i - 32) / 16.0))) & 0xFF
+                 for i in range(64))
+    rng = random.Random(3)
+    hat = bytes(int(rng.uniform(-80, 80) * math.exp(-i / 120.0)) & 0xFF
+                for i in range(600))
+    # (name, data, volume, loop start, loop length) with loops in bytes
+    return [
+        ('lead', lead, 40, 0, len(lead)),
+        ('bass', bass, 48, 0, len(bass)),
+        ('hat', hat, 24, 0, 2),
+    ]
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else 'korobeiniki.mod'
+
+    part_a = [empty_pattern(), empty_pattern()]
+    part_b = [empty_pattern(), empty_pattern()]
+    write_melody(part_a, PART_A)
+    write_bass(part_a, PART_A_BASS)
+    write_melody(part_b, PART_B)
+    write_bass(part_b, PART_B_BASS)
+    patterns = part_a + part_b
+    write_hats(patterns)
+    order = [0, 1, 0, 1, 2, 3]
+
+    data = bytearray(b'korobeiniki'.ljust(20, b'\0'))
+    instruments = samples()
+    for i in range(31):
+        if i < len(instruments):
+            name, sample, volume, loop_start, loop_length = instruments[i]
+            data += name.encode().ljust(22, b'\0')
+            data += struct.pack('>HBBHH', len(sample) // 2, 0, volume,
+                                loop_start // 2, loop_length // 2)
+        else:
+            data += bytes(22) + struct.pack('>HBBHH', 0, 0, 0, 0, 1)
+    data += bytes([len(order), 127])
+    data += bytes(order).ljust(128, b'\0')
+    data += b'M.K.'
+    for pattern in patterns:
+        for row in pattern:
+            data += b''.join(row)
+    for instrument in instruments:
+        data += instrument[1]
+
+    with open(out, 'wb') as f:
+        f.write(data)
+    print('%s: %d bytes' % (out, len(data)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Turns the sampling profiler's log into a flat profile.
+
+Usage: profsym.py Pentris.map log.txt
+
+The log is whatever the emulator wrote to its debug log from a build made
+with PROFILE_SAMPLES (see src/sampler.c). Every dump in the log is added up.
+Each sampled address is matched to the function containing it using the map
+file the linker writes. Static functions aren't in the map, so their samples
+are counted against the function before them in the same object file.
+"""
+
+import bisect
+import re
+import sys
+
+SECTION_RE = re.compile(
+    r'^\s*(\.\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+\.o\S*)\s*$')
+SYMBOL_RE = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_][\w.$]*)\s*$')
+HEADER_RE = re.compile(r'samples ([0-9A-F]{8}) ([0-9A-F]{8})')
+SAMPLE_RE = re.compile(r'sample ([0-9A-F]{8}) ([0-9A-F]{4})')
+
+CODE_SECTIONS = ('.text', '.iwram')
+
+
+def read_map(path):
+    """Returns a sorted list of (address, end, name, object) for code."""
+    sections = []
+    symbols = []
+    pending_name = None
+    with open(path) as f:
+        for line in f:
+            line = line.rstrip('\n')
+            # Long section names are put on a line of their own
+            if re.match(r'^ \.\S+$', line):
+                pending_name = line.strip()
+                continue
+
+            match = SECTION_RE.match(line)
+            if match:
+                name = match.group(1) or pending_name or ''
+                pending_name = None
+                start = int(match.group(2), 16)
+                size = int(match.group(3), 16)
+                if size and name.startswith(CODE_SECTIONS):
+                    sections.append((start, start + size, match.group(4)))
+                continue
+            pending_name = None
+
+            match = SYMBOL_RE.match(line)
+            if match:
+                symbols.append((int(match.group(1), 16), match.group(2)))
+
+    labels = []
+    for start, end, obj in sections:
+        obj = obj.split('/')[-1]
+        names = sorted((a, n) for a, n in symbols if start <= a < end)
+        if not names or names[0][0] != start:
+            names.insert(0, (start, '(%s)' % obj))
+        for i, (address, name) in enumerate(names):
+            label_end = names[i + 1][0] if i + 1 < len(names) else end
+            labels.append((address, label_end, name, obj))
+    labels.sort()
+    return labels
+
+
+def read_samples(path):
+    """Returns ({address: count}, total, other) summed over every dump."""
+    samples = {}
+    total = 0
+    other = 0
+    with open(path, errors='replace') as f:
+        for line in f:
+            match = HEADER_RE.search(line)
+            if match:
+                total += int(match.group(1), 16)
+                other += int(match.group(2), 16)
+                continue
+            match = SAMPLE_RE.search(line)
+            if match:
+                address = int(match.group(1), 16)
+                samples[address] = samples.get(address, 0) + int(match.group(2), 16)
+    return samples, total, other
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+
+    labels = read_map(sys.argv[1])
+    starts = [label[0] for label in labels]
+    samples, total, other = read_samples(sys.argv[2])
+    if not total:
+        sys.exit('no samples in %s' % sys.argv[2])
+
+    functions = {}
+    for address, count in samples.items():
+        i = bisect.bisect_right(starts, address) - 1
+        if i >= 0 and address < labels[i][1]:
+            key = (labels[i][2], labels[i][3])
+        else:
+            key = ('0x%08x' % address, '?')
+        functions[key] = functions.get(key, 0) + count
+    if other:
+        functions[('(bios, or off the histogram)', '')] = other
+
+    print('%d samples' % total)
+    print('%7s %8s  %s' % ('%', 'samples', 'function'))
+    for (name, obj), count in sorted(functions.items(), key=lambda f: -f[1]):
+        where = '  [%s]' % obj if obj else ''
+        print('%6.2f%% %8d  %s%s' % (100.0 * count / total, count, name, where))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Synthesizes the sound effect samples in src/sfx.
+
+Usage: sfxgen.py [outdir]
+
+Each effect is written as <NAME>.c and <NAME>.h holding signed 8-bit samples
+at the rate music.c plays at, so src/mixer.c can mix them without resampling.
+"""
+
+import math
+import os
+import random
+import sys
+
+RATE = (1 << 24) / 798  # AUDIO_CYCLES_PER_SAMPLE in music.h
+
+
+def square(freq, t):
+    return 1.0 if math.sin(2 * math.pi * freq * t) >= 0 else -1.0
+
+
+def envelope(t, length, attack=0.005):
+    if t < attack:
+        return t / attack
+    return max(0.0, 1.0 - (t - attack) / (length - attack)) ** 2
+
+
+def lock():
+    length = 0.06
+    rng = random.Random(1)
+    out = []
+    for i in range(int(length * RATE)):
+        t = i / RATE
+        v = 0.7 * math.sin(2 * math.pi * 110 * t) + 0.3 * rng.uniform(-1, 1)
+        out.append(v * envelope(t, length))
+    return out
+
+
+def hard_drop():
+    length = 0.12
+    rng = random.Random(2)
+    out = []
+    phase = 0.0
+    for i in range(int(length * RATE)):
+        t = i / RATE
+        freq = 400 - 300 * t / length
+        phase += freq / RATE
+        v = 0.5 * math.sin(2 * math.pi * phase) + 0.5 * rng.uniform(-1, 1)
+        out.append(v * envelope(t, length))
+    return out
+
+
+def line_clear():
+    notes = [523.25, 659.25, 783.99, 1046.5]
+    note_length = 0.075
+    out = []
+    for freq in notes:
+        for i in range(int(note_length * RATE)):
+            t = i / RATE
+            out.append(0.6 * square(freq, t) * envelope(t, note_length, 0.002))
+    return out
+
+
+def game_over():
+    length = 0.8
+    out = []
+    phase = 0.0
+    for i in range(int(length * RATE)):
+        t = i / RATE
+        freq = 440 * 2 ** (-2 * t / length)
+        phase += freq / RATE
+        v = 0.6 * (1.0 if math.sin(2 * math.pi * phase) >= 0 else -1.0)
+        out.append(v * envelope(t, length, 0.01))
+    return out
+
+
+EFFECTS = [
+    ('SFX_LOCK', lock),
+    ('SFX_HARD_DROP', hard_drop),
+    ('SFX_LINE_CLEAR', line_clear),
+    ('SFX_GAME_OVER', game_over),
+]
+
+
+def main():
+    outdir = sys.argv[1] if len(sys.argv) > 1 else '.'
+    for name, synth in EFFECTS:
+        samples = [max(-128, min(127, int(round(v * 127)))) for v in synth()]
+        with open(os.path.join(outdir, name + '.h'), 'w') as h:
+            h.write('#define %s_LENGTH %d\n' % (name, len(samples)))
+            h.write('extern const signed char %s_data[%d];\n'
+                    % (name, len(samples)))
+        with open(os.path.join(outdir, name + '.c'), 'w') as c:
+            c.write('const signed char %s_data[%d] = {\n' % (name, len(samples)))
+            for i in range(0, len(samples), 16):
+                c.write(', '.join(str(s) for s in samples[i:i + 16]) + ',\n')
+            c.write('};\n')
+        print('%s: %d samples' % (name, len(samples)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""Converts a WAV file into 4-bit IMA ADPCM blocks for src/music.c.
+
+Usage: wav2adpcm.py input.wav name [outdir]
+
+Writes <outdir>/<name>.c and <outdir>/<name>.h. The audio is mixed down to
+mono and resampled to the rate music.c plays at (one block of
+BLOCK_SAMPLES samples per frame). The block layout is described in
+src/adpcm.h, and the tables below must match the ones in src/adpcm.c.
+"""
+
+import os
+import struct
+import sys
+import time
+import wave
+
+CPU_FREQUENCY = 1 << 24
+CYCLES_PER_SAMPLE = 798  # AUDIO_CYCLES_PER_SAMPLE in music.h
+BLOCK_SAMPLES = 352      # AUDIO_FRAME_SAMPLES in music.h
+HEADER_SIZE = 4
+RATE = CPU_FREQUENCY / CYCLES_PER_SAMPLE
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41,
+    45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209,
+    230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876,
+    963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749,
+    3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+    9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623,
+    27086, 29794, 32767,
+]
+
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def read_wav(path):
+    """Returns (rate, samples) with samples as mono 16-bit ints."""
+    with wave.open(path, 'rb') as wav:
+        channels = wav.getnchannels()
+        width = wav.getsampwidth()
+        rate = wav.getframerate()
+        frames = wav.readframes(wav.getnframes())
+
+    if width == 1:
+        values = [b - 128 << 8 for b in frames]
+    elif width == 2:
+        values = list(struct.unpack('<%dh' % (len(frames) // 2), frames))
+    else:
+        sys.exit('only 8 and 16 bit WAV files are supported')
+
+    mono = []
+    for i in range(0, len(values), channels):
+        mono.append(sum(values[i:i + channels]) // channels)
+    return rate, mono
+
+
+def resample(samples, rate):
+    """Linearly resamples to RATE."""
+    length = int(round(len(samples) * RATE / rate))
+    out = []
+    for i in range(length):
+        pos = i * rate / RATE
+        j = int(pos)
+        frac = pos - j
+        a = samples[min(j, len(samples) - 1)]
+        b = samples[min(j + 1, len(samples) - 1)]
+        out.append(int(round(a + (b - a) * frac)))
+    return out
+
+
+def encode(samples):
+    """Encodes samples into a list of blocks (bytes)."""
+    blocks = []
+    predicted = 0
+    index = 0
+    for start in range(0, len(samples), BLOCK_SAMPLES):
+        chunk = samples[start:start + BLOCK_SAMPLES]
+        chunk += [0] * (BLOCK_SAMPLES - len(chunk))
+
+        block = bytearray(struct.pack('<hBB', predicted, index, 0))
+        nibbles = []
+        for sample in chunk:
+            step = STEP_TABLE[index]
+            delta = sample - predicted
+            nibble = 0
+            if delta < 0:
+                nibble = 8
+                delta = -delta
+            if delta >= step:
+                nibble |= 4
+                delta -= step
+            if delta >= step >> 1:
+                nibble |= 2
+                delta -= step >> 1
+            if delta >= step >> 2:
+                nibble |= 1
+
+            # Track the decoder exactly, so rounding never drifts
+            diff = step >> 3
+            if nibble & 1:
+                diff += step >> 2
+            if nibble & 2:
+                diff += step >> 1
+            if nibble & 4:
+                diff += step
+            if nibble & 8:
+                predicted = max(predicted - diff, -32768)
+            else:
+                predicted = min(predicted + diff, 32767)
+            index = min(max(index + INDEX_TABLE[nibble], 0), 88)
+            nibbles.append(nibble)
+
+        for i in range(0, BLOCK_SAMPLES, 2):
+            block.append(nibbles[i] | nibbles[i + 1] << 4)
+        blocks.append(bytes(block))
+    return blocks
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    path, name = sys.argv[1], sys.argv[2]
+    outdir = sys.argv[3] if len(sys.argv) > 3 else '.'
+
+    rate, samples = read_wav(path)
+    samples = resample(samples, rate)
+    blocks = encode(samples)
+    data = b''.join(blocks)
+    upper = name.upper()
+
+    with open(os.path.join(outdir, name + '.h'), 'w') as h:
+        h.write('\n/' + '*' * 62 + '\n')
+        h.write(' *    \n')
+        h.write(' *    %s, 4 bit IMA ADPCM, %dHz,\n' % (name, int(RATE)))
+        h.write(' *    1 channel, %d samples in %d blocks of %d\n'
+                % (len(samples), len(blocks), BLOCK_SAMPLES))
+        h.write(' *    Total Size: %d * %d = %d bytes\n'
+                % (len(blocks), len(blocks[0]), len(data)))
+        h.write(' *    \n')
+        h.write(' *    Generated by tools/wav2adpcm.py from:\n')
+        h.write(' *    %s\n' % os.path.basename(path))
+        h.write(' *    \n')
+        h.write(' ' + '*' * 62 + '/\n\n')
+        h.write('#ifndef __%sH__\n#define __%sH__\n\n' % (upper, upper))
+        h.write('#define %s_RATE %d\n' % (upper, int(RATE)))
+        h.write('#define %s_LENGTH %d\n' % (upper, len(samples)))
+        h.write('#define %s_BLOCK_SAMPLES %d\n' % (upper, BLOCK_SAMPLES))
+        h.write('#define %s_BLOCKS %d\n\n' % (upper, len(blocks)))
+        h.write('extern const unsigned char %s[%d];\n\n' % (name, len(data)))
+        h.write('#endif /* __%sH__ */\n' % upper)
+
+    with open(os.path.join(outdir, name + '.c'), 'w') as c:
+        c.write('// Generated by tools/wav2adpcm.py from %s on %s\n\n'
+                % (os.path.basename(path), time.ctime()))
+        c.write('const unsigned char %s[%d] = {\n' % (name, len(data)))
+        for i in range(0, len(data), 16):
+            c.write(', '.join(str(b) for b in data[i:i + 16]) + ',\n')
+        c.write('};\n')
+
+    print('%s: %d samples, %d bytes (%.2fx smaller than 8-bit PCM)'
+          % (name, len(samples), len(data), len(samples) / len(data)))
+
+
+if __name__ == '__main__':
+    main()